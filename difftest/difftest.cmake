@@ -0,0 +1,13 @@
+# the randomized differential driver, see driver.cpp. The tests run a
+# short fixed-seed stream per container under the label difftest; larger
+# runs are done by hand, e.g. stlite-difftest --ops 100000000 map.
+
+add_executable(stlite-difftest "${CMAKE_CURRENT_LIST_DIR}/driver.cpp")
+target_include_directories(stlite-difftest PRIVATE
+        ${CMAKE_CURRENT_SOURCE_DIR}/vector/src ${CMAKE_CURRENT_SOURCE_DIR}/map/src ${CMAKE_CURRENT_SOURCE_DIR}/priority_queue/src)
+
+foreach (name vector map leftist lazy dary pairing)
+    add_test(NAME difftest-${name} COMMAND stlite-difftest --ops 200000 --check-every 10000 ${name})
+    math(EXPR timeout "20 * ${STLITE_TIMEOUT_SCALE}")
+    set_tests_properties(difftest-${name} PROPERTIES LABELS difftest TIMEOUT ${timeout})
+endforeach ()
@@ -0,0 +1,348 @@
+// randomized differential test: a stream of operations, generated from a
+// seed, is applied in lock-step to an sjtu:: container and its std::
+// counterpart, and every result is compared, as is the whole content every
+// --check-every operations. Then the same stream runs on each side alone
+// to measure its throughput. The stream is regenerated rather than stored,
+// so --ops can go to 10^8 and beyond; a mismatch is reproduced by the seed.
+//
+// usage: stlite-difftest [--ops N] [--seed S] [--keys K] [--check-every N] [container...]
+//
+// containers: vector, map, leftist, lazy, dary, pairing (the priority_queue
+// policies), or all, the default. Keys are drawn from [0, K), which also
+// bounds the sizes of the vectors and queues.
+#include "dary_heap.hpp"
+#include "map.hpp"
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+#include "vector.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct options {
+	long long ops = 1000000;
+	unsigned long long seed = 1;
+	int keys = 1 << 16;
+	long long check_every = 100000;
+};
+
+struct xorshift {
+	unsigned long long s;
+	explicit xorshift(unsigned long long seed) : s(seed * 0x9e3779b97f4a7c15ull | 1) {}
+	unsigned long long next() {
+		s ^= s << 13;
+		s ^= s >> 7;
+		s ^= s << 17;
+		return s;
+	}
+};
+
+long long mix(long long h, long long x) { return (h ^ x) * 1099511628211ll + 7; }
+
+struct op {
+	int kind, key, value;
+};
+
+/**
+ * the operation stream. weights[k] is the share of kind k in parts per
+ * million; the last kind takes what is left.
+ */
+class generator {
+public:
+	generator(const options &opt, const std::vector<int> &weights) : _rng(opt.seed), _keys(opt.keys) {
+		int acc = 0;
+		for (int w : weights) _bound.push_back(acc += w);
+	}
+	op next() {
+		unsigned long long r = _rng.next();
+		int pick = (int) (r % 1000000), kind = 0;
+		while (kind + 1 < (int) _bound.size() && pick >= _bound[kind]) ++kind;
+		return {kind, (int) ((r >> 20) % _keys), (int) (r >> 40)};
+	}
+
+private:
+	xorshift _rng;
+	int _keys;
+	std::vector<int> _bound;
+};
+
+// ---- vector ----
+
+enum { v_push, v_pop, v_insert, v_erase, v_read, v_write, v_iterate, v_copy, v_clear };
+const char *vector_kinds[] = {"push_back", "pop_back", "insert", "erase", "read", "write", "iterate", "copy", "clear"};
+const std::vector<int> vector_weights = {300000, 250000, 2000, 2000, 200000, 150000, 95993, 5, 2};
+
+template<class V>
+struct vector_side {
+	V v;
+	int keys;
+
+	long long digest() const {
+		long long h = (long long) v.size();
+		for (size_t i = 0; i < v.size(); ++i) h = mix(h, v[i]);
+		return h;
+	}
+	long long apply(const op &o) {
+		size_t n = v.size();
+		int kind = o.kind;
+		if (!n && kind != v_push && kind != v_insert && kind != v_clear) kind = v_push;
+		if (n >= (size_t) keys && (kind == v_push || kind == v_insert)) kind = v_pop;
+		switch (kind) {
+		case v_push:
+			v.push_back(o.value);
+			return (long long) v.size();
+		case v_pop:
+			v.pop_back();
+			return (long long) v.size();
+		case v_insert:
+			v.insert(v.begin() + o.key % (n + 1), o.value);
+			return (long long) v.size();
+		case v_erase:
+			v.erase(v.begin() + o.key % n);
+			return (long long) v.size();
+		case v_read:
+			return v[o.key % n];
+		case v_write:
+			v[o.key % n] = o.value;
+			return v[o.key % n];
+		case v_iterate: {
+			long long h = 0;
+			auto it = v.begin() + o.key % n;
+			for (int k = 0; k < 16 && it != v.end(); ++k, ++it) h = mix(h, *it);
+			return h;
+		}
+		case v_copy: {
+			V c(v);
+			v = c;
+			return digest();
+		}
+		default:
+			v.clear();
+			return 0;
+		}
+	}
+};
+
+// ---- map ----
+
+enum { m_insert, m_erase, m_find, m_assign, m_iterate, m_split, m_copy, m_clear };
+const char *map_kinds[] = {"insert", "erase", "find", "assign", "iterate", "split", "copy", "clear"};
+const std::vector<int> map_weights = {300000, 250000, 250000, 100000, 99973, 20, 5, 2};
+
+template<class M>
+struct map_side {
+	M m;
+	int keys;
+
+	long long digest() const {
+		long long h = (long long) m.size();
+		for (auto it = m.cbegin(); it != m.cend(); ++it) h = mix(mix(h, it->first), it->second);
+		return h;
+	}
+	long long apply(const op &o) {
+		switch (o.kind) {
+		case m_insert: {
+			auto r = m.insert(typename M::value_type(o.key, o.value));
+			return r.second * 2 + (r.first->second == o.value);
+		}
+		case m_erase: {
+			auto it = m.find(o.key);
+			if (it == m.end()) return -1;
+			m.erase(it);
+			return (long long) m.size();
+		}
+		case m_find: {
+			auto it = m.find(o.key);
+			return it == m.end() ? -1 : it->second;
+		}
+		case m_assign:
+			m[o.key] = o.value;
+			return (long long) m.size();
+		case m_iterate: {
+			auto it = m.find(o.key);
+			if (it == m.end()) it = m.begin();
+			long long h = 0;
+			for (int k = 0; k < 16 && it != m.end(); ++k, ++it) h = mix(mix(h, it->first), it->second);
+			return h;
+		}
+		case m_split: {
+			// cut off the keys from o.key on and put them back.
+			size_t cut;
+			if constexpr (requires { m.split_at(o.key); }) {
+				M rest = m.split_at(o.key);
+				cut = rest.size();
+				m.union_with(std::move(rest));
+			} else {
+				M rest(m.lower_bound(o.key), m.end());
+				m.erase(m.lower_bound(o.key), m.end());
+				cut = rest.size();
+				m.merge(rest);
+			}
+			return (long long) cut;
+		}
+		case m_copy: {
+			M c(m);
+			m = c;
+			return digest();
+		}
+		default:
+			m.clear();
+			return 0;
+		}
+	}
+};
+
+// ---- priority_queue ----
+
+enum { q_push, q_pop, q_top, q_merge, q_copy, q_clear };
+const char *queue_kinds[] = {"push", "pop", "top", "merge", "copy", "clear"};
+const std::vector<int> queue_weights = {400000, 350000, 200000, 49993, 5, 2};
+
+template<class Q>
+struct queue_side {
+	Q q;
+	int keys;
+
+	static long long drain(Q c) {
+		long long h = (long long) c.size();
+		for (; !c.empty(); c.pop()) h = mix(h, c.top());
+		return h;
+	}
+	long long digest() const { return drain(q); }
+	long long apply(const op &o) {
+		int kind = o.kind;
+		if (q.size() >= (size_t) keys && (kind == q_push || kind == q_merge)) kind = q_pop;
+		switch (kind) {
+		case q_push:
+			q.push(o.key);
+			break;
+		case q_pop:
+			if (q.empty()) return -1;
+			q.pop();
+			break;
+		case q_top:
+			break;
+		case q_merge: {
+			// a batch of up to 32 keys, derived from the op, merged in.
+			Q other;
+			xorshift r((unsigned long long) o.value);
+			for (int k = o.key % 32; k >= 0; --k) other.push((int) (r.next() % keys));
+			if constexpr (requires { q.merge(other); }) {
+				q.merge(other);
+			} else {
+				for (; !other.empty(); other.pop()) q.push(other.top());
+			}
+			break;
+		}
+		case q_copy: {
+			Q c(q);
+			q = c;
+			return digest();
+		}
+		default:
+			q = Q();
+			return 0;
+		}
+		return q.empty() ? -1 : mix((long long) q.size(), q.top());
+	}
+};
+
+// ---- the driver ----
+
+using clock_type = std::chrono::steady_clock;
+
+double seconds_since(clock_type::time_point start) {
+	return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+template<class Side>
+double alone(const options &opt, const std::vector<int> &weights) {
+	generator gen(opt, weights);
+	Side s{{}, opt.keys};
+	long long sink = 0;
+	auto start = clock_type::now();
+	for (long long i = 0; i < opt.ops; ++i) sink += s.apply(gen.next());
+	double t = seconds_since(start);
+	if (sink == 42) puts("");
+	return opt.ops / t;
+}
+
+template<class Ours, class Theirs>
+bool run(const char *name, const options &opt, const std::vector<int> &weights, const char *const *kinds) {
+	printf("%s: %lld ops, seed %llu, %d keys\n", name, opt.ops, opt.seed, opt.keys);
+	generator gen(opt, weights);
+	Ours ours{{}, opt.keys};
+	Theirs theirs{{}, opt.keys};
+	auto start = clock_type::now();
+	for (long long i = 0; i < opt.ops; ++i) {
+		op o = gen.next();
+		long long a = ours.apply(o), b = theirs.apply(o);
+		bool full = opt.check_every && (i + 1) % opt.check_every == 0;
+		if (a == b && full) a = ours.digest(), b = theirs.digest();
+		if (a != b) {
+			printf("  mismatch at op %lld (%s %d %d)%s: sjtu %lld, std %lld\n", i, kinds[o.kind], o.key, o.value,
+				   full ? ", full check" : "", a, b);
+			return false;
+		}
+	}
+	if (ours.digest() != theirs.digest()) {
+		printf("  mismatch in the final contents\n");
+		return false;
+	}
+	double checked = opt.ops / seconds_since(start);
+	double sjtu_rate = alone<Ours>(opt, weights), std_rate = alone<Theirs>(opt, weights);
+	printf("  lock-step %12.0f ops/s, ok\n  sjtu      %12.0f ops/s\n  std       %12.0f ops/s\n", checked, sjtu_rate, std_rate);
+	return true;
+}
+
+template<class Policy>
+using sjtu_queue = queue_side<sjtu::priority_queue<int, std::less<int>, Policy>>;
+using std_queue = queue_side<std::priority_queue<int>>;
+
+bool run_one(const std::string &name, const options &opt) {
+	if (name == "vector")
+		return run<vector_side<sjtu::vector<int>>, vector_side<std::vector<int>>>("vector", opt, vector_weights, vector_kinds);
+	if (name == "map")
+		return run<map_side<sjtu::map<int, int>>, map_side<std::map<int, int>>>("map", opt, map_weights, map_kinds);
+	if (name == "leftist")
+		return run<sjtu_queue<sjtu::leftist_heap>, std_queue>("priority_queue (leftist)", opt, queue_weights, queue_kinds);
+	if (name == "lazy")
+		return run<sjtu_queue<sjtu::lazy_leftist_heap>, std_queue>("priority_queue (lazy)", opt, queue_weights, queue_kinds);
+	if (name == "dary")
+		return run<sjtu_queue<sjtu::dary_heap<4>>, std_queue>("priority_queue (dary<4>)", opt, queue_weights, queue_kinds);
+	if (name == "pairing")
+		return run<sjtu_queue<sjtu::pairing_heap>, std_queue>("priority_queue (pairing)", opt, queue_weights, queue_kinds);
+	printf("unknown container %s\n", name.c_str());
+	return false;
+}
+
+}// namespace
+
+int main(int argc, char **argv) {
+	options opt;
+	std::vector<std::string> names;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool has_value = i + 1 < argc;
+		if (arg == "--ops" && has_value) opt.ops = atoll(argv[++i]);
+		else if (arg == "--seed" && has_value) opt.seed = strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--keys" && has_value) opt.keys = atoi(argv[++i]);
+		else if (arg == "--check-every" && has_value) opt.check_every = atoll(argv[++i]);
+		else if (arg == "all") names.insert(names.end(), {"vector", "map", "leftist", "lazy", "dary", "pairing"});
+		else names.push_back(arg);
+	}
+	if (names.empty()) names = {"vector", "map", "leftist", "lazy", "dary", "pairing"};
+	if (opt.keys < 1) opt.keys = 1;
+	bool ok = true;
+	for (const std::string &name : names) ok &= run_one(name, opt);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+// request-scoped work: each request builds a small map, looks keys up,
+// erases some and throws the map away. The map allocates from
+// std::allocator, or from an arena released (or reset) after every request, with or
+// without a buffer on the stack. Times are ns per key inserted.
+//
+// usage: map-bench-arena [keys per request] [requests]
+#include "arena.hpp"
+#include "map.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+
+using clock_type = std::chrono::steady_clock;
+
+unsigned long long seed = 88172645463325252ull;
+unsigned Rand() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (unsigned) (seed >> 32);
+}
+
+template<template<typename> class Alloc>
+long long request(int n) {
+	sjtu::map<int, long long, std::less<int>, Alloc> m;
+	for (int i = 0; i < n; ++i) m[(int) (Rand() % (4 * n))] += i;
+	long long sink = 0;
+	for (int i = 0; i < n; ++i) {
+		auto it = m.find((int) (Rand() % (4 * n)));
+		if (it != m.end()) {
+			sink += it->second;
+			if (i % 2) m.erase(it);
+		}
+	}
+	return sink + (long long) m.size();
+}
+
+template<template<typename> class Alloc>
+void run(const char *name, int n, int requests, sjtu::arena *a, bool reset = false) {
+	seed = 88172645463325252ull;
+	long long sink = 0;
+	auto start = clock_type::now();
+	for (int r = 0; r < requests; ++r) {
+		if (a) {
+			{
+				sjtu::resource_scope scope(a);
+				sink += request<Alloc>(n);
+			}
+			reset ? a->reset() : a->release();
+		} else {
+			sink += request<Alloc>(n);
+		}
+	}
+	double t = std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / ((double) n * requests);
+	printf("%-30s %10.1f%s\n", name, t, sink == 42 ? " " : "");
+}
+
+template<typename Type>
+using std_alloc = std::allocator<Type>;
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? atoi(argv[1]) : 1000;
+	int requests = argc > 2 ? atoi(argv[2]) : 2000;
+	printf("%d keys per request, %d requests, ns per key\n", n, requests);
+	run<std_alloc>("std::allocator", n, requests, nullptr);
+	sjtu::arena a;
+	run<sjtu::polymorphic_allocator>("arena", n, requests, &a);
+	run<sjtu::polymorphic_allocator>("arena, reset", n, requests, &a, true);
+	static unsigned char buffer[1 << 16];
+	sjtu::arena b(buffer, sizeof(buffer));
+	run<sjtu::polymorphic_allocator>("arena on a 64 KiB buffer", n, requests, &b);
+	return 0;
+}
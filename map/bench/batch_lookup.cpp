@@ -0,0 +1,63 @@
+// batches of 32..256 random keys against a map larger than the cache:
+// one find() per key, find_batch (interleaved descents), and
+// find_batch_sorted on the same batch sorted beforehand (sort included).
+//
+// usage: map-bench-batch_lookup [keys] [batches]
+#include "map.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+using smap = sjtu::map<int, int>;
+
+unsigned long long seed = 88172645463325252ull;
+unsigned Rand() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (unsigned) (seed >> 32);
+}
+
+template<class F>
+double per_key(int batches, int width, F f) {
+	auto start = clock_type::now();
+	for (int b = 0; b < batches; ++b) f(b);
+	return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / batches / width;
+}
+
+int main(int argc, char **argv) {
+	int keys = argc > 1 ? std::atoi(argv[1]) : 1 << 22;
+	int batches = argc > 2 ? std::atoi(argv[2]) : 1 << 14;
+	smap m;
+	for (int i = 0; i < keys; ++i) m[(int) (Rand() % (2u * keys))] = i;
+
+	printf("map of %zu keys, %d batches per width\n", m.size(), batches);
+	printf("%6s %14s %14s %14s\n", "width", "find ns/key", "batch ns/key", "sorted ns/key");
+	for (int width = 32; width <= 256; width *= 2) {
+		std::vector<int> probes((size_t) batches * width), scratch(width);
+		for (int &k : probes) k = (int) (Rand() % (2u * keys));
+		std::vector<smap::iterator> out(width);
+		long long sink = 0;
+		double single = per_key(batches, width, [&](int b) {
+			const int *p = probes.data() + (size_t) b * width;
+			for (int i = 0; i < width; ++i) sink += m.find(p[i]) != m.end();
+		});
+		double batch = per_key(batches, width, [&](int b) {
+			const int *p = probes.data() + (size_t) b * width;
+			m.find_batch(p, p + width, out.begin());
+			sink += out[0] != m.end();
+		});
+		double sorted = per_key(batches, width, [&](int b) {
+			const int *p = probes.data() + (size_t) b * width;
+			std::copy(p, p + width, scratch.begin());
+			std::sort(scratch.begin(), scratch.end());
+			m.find_batch_sorted(scratch.begin(), scratch.end(), out.begin());
+			sink += out[0] != m.end();
+		});
+		printf("%6d %14.1f %14.1f %14.1f%s\n", width, single, batch, sorted, sink == 42 ? " " : "");
+	}
+	return 0;
+}
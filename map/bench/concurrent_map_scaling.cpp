@@ -0,0 +1,97 @@
+// stress and throughput of concurrent_map against a mutex-guarded
+// sjtu::map, from one thread up to all hardware threads.
+// Every thread runs the same random mix of find / insert / erase over a
+// shared key range; after each point the map is checked for order and size.
+//
+// usage: map-bench-concurrent_map_scaling [keys] [millis per point] [find %]
+#include "concurrent_map.hpp"
+#include "map.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+
+struct xorshift {
+	unsigned long long s;
+	unsigned long long operator()() {
+		s ^= s << 13;
+		s ^= s >> 7;
+		s ^= s << 17;
+		return s;
+	}
+};
+
+// op(kind, key): kind 0 = find, 1 = insert, 2 = erase
+template<class Op>
+double run(int threads, int millis, int keys, int find_pct, Op op) {
+	std::atomic<bool> stop{false};
+	std::atomic<unsigned long long> total{0};
+	std::vector<std::thread> pool;
+	for (int t = 0; t < threads; ++t)
+		pool.emplace_back([&, t] {
+			xorshift rng{0x9e3779b97f4a7c15ull * (t + 1)};
+			unsigned long long ops = 0;
+			while (!stop.load(std::memory_order_relaxed)) {
+				for (int i = 0; i < 256; ++i) {
+					unsigned long long x = rng();
+					int pct = (int) (x % 100), key = (int) ((x >> 8) % keys);
+					op(pct < find_pct ? 0 : (pct - find_pct) % 2 + 1, key);
+				}
+				ops += 256;
+			}
+			total += ops;
+		});
+	auto start = clock_type::now();
+	std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+	stop = true;
+	for (auto &th : pool) th.join();
+	double sec = std::chrono::duration<double>(clock_type::now() - start).count();
+	return total.load() / sec;
+}
+
+int main(int argc, char **argv) {
+	int keys = argc > 1 ? std::atoi(argv[1]) : 1 << 16;
+	int millis = argc > 2 ? std::atoi(argv[2]) : 300;
+	int find_pct = argc > 3 ? std::atoi(argv[3]) : 50;
+	int hw = (int) std::thread::hardware_concurrency();
+	if (hw <= 0) hw = 1;
+
+	sjtu::concurrent_map<int, int> cmap;
+	sjtu::map<int, int> locked;
+	std::mutex mtx;
+	for (int i = 0; i < keys; i += 2) {
+		cmap.insert({i, i});
+		locked[i] = i;
+	}
+
+	printf("%8s %16s %16s %8s %8s\n", "threads", "skiplist ops/s", "mutex ops/s", "ratio", "check");
+	for (int t = 1;; t = t * 2 > hw ? hw : t * 2) {
+		double c = run(t, millis, keys, find_pct, [&](int kind, int key) {
+			if (kind == 0) return (void) cmap.count(key);
+			if (kind == 1) return (void) cmap.insert({key, key});
+			cmap.erase(key);
+		});
+		double m = run(t, millis, keys, find_pct, [&](int kind, int key) {
+			std::lock_guard<std::mutex> lock(mtx);
+			if (kind == 0) return (void) locked.count(key);
+			if (kind == 1) return (void) locked.insert({key, key});
+			auto it = locked.find(key);
+			if (it != locked.end()) locked.erase(it);
+		});
+		size_t n = 0;
+		bool ordered = true;
+		int last = -1;
+		for (auto it = cmap.begin(); it != cmap.end(); ++it, ++n) {
+			ordered &= last < it->first && it->first == it->second;
+			last = it->first;
+		}
+		printf("%8d %16.0f %16.0f %8.2f %8s\n", t, c, m, c / m, ordered && n == cmap.size() ? "ok" : "BROKEN");
+		if (t == hw) break;
+	}
+	return 0;
+}
@@ -0,0 +1,77 @@
+// random lookups on a map much larger than the last-level cache.
+// sjtu::map<int, int> takes the branchless, prefetching descent; the same
+// map with an opaque comparator takes the generic two-comparison loop.
+// map-bench-descent_no_prefetch is this with the prefetches compiled out,
+// the branchless descent alone.
+//
+// usage: map-bench-descent [keys] [lookups]
+#include "map.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+
+using clock_type = std::chrono::steady_clock;
+
+struct opaque_less {
+	bool operator()(int a, int b) const { return a < b; }
+};
+
+unsigned long long seed = 88172645463325252ull;
+unsigned Rand() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (unsigned) (seed >> 32);
+}
+
+template<class Map>
+double run(Map &m, const int *probes, int lookups, long long &sink) {
+	auto start = clock_type::now();
+	for (int i = 0; i < lookups; ++i) {
+		auto it = m.find(probes[i]);
+		if (it != m.end()) sink += it->second;
+	}
+	return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / lookups;
+}
+
+int main(int argc, char **argv) {
+	int keys = argc > 1 ? std::atoi(argv[1]) : 1 << 22;
+	int lookups = argc > 2 ? std::atoi(argv[2]) : 1 << 22;
+	int *order = new int[keys], *probes = new int[lookups];
+	for (int i = 0; i < keys; ++i) order[i] = i * 2;
+	// insert in random order so neighbouring keys are not neighbours in memory
+	for (int i = keys - 1; i > 0; --i) {
+		int j = (int) (Rand() % (i + 1));
+		int t = order[i];
+		order[i] = order[j];
+		order[j] = t;
+	}
+	for (int i = 0; i < lookups; ++i) probes[i] = (int) (Rand() % (2u * keys));
+
+	sjtu::map<int, int> fast;
+	sjtu::map<int, int, opaque_less> generic;
+	std::map<int, int> reference;
+	for (int i = 0; i < keys; ++i) {
+		fast[order[i]] = i;
+		generic[order[i]] = i;
+		reference[order[i]] = i;
+	}
+
+	long long sink = 0;
+	double t_generic = run(generic, probes, lookups, sink);
+	double t_fast = run(fast, probes, lookups, sink);
+	double t_std = run(reference, probes, lookups, sink);
+	printf("keys %d, lookups %d (half of them miss)\n", keys, lookups);
+	printf("%-24s %8.1f ns/lookup\n", "generic descent", t_generic);
+#ifdef SJTU_MAP_NO_PREFETCH
+	const char *fast_name = "branchless";
+#else
+	const char *fast_name = "branchless + prefetch";
+#endif
+	printf("%-24s %8.1f ns/lookup  (%.2fx)\n", fast_name, t_fast, t_generic / t_fast);
+	printf("%-24s %8.1f ns/lookup\n", "std::map", t_std);
+	delete[] order;
+	delete[] probes;
+	return sink == 42;
+}
@@ -0,0 +1,3 @@
+// map-bench-descent without the prefetches, see there.
+#define SJTU_MAP_NO_PREFETCH
+#include "descent.cpp"
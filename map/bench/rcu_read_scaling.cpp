@@ -0,0 +1,91 @@
+// read throughput of rcu_map against a mutex-guarded sjtu::map,
+// from one reader thread up to all hardware threads, with one writer
+// publishing a new version every few milliseconds.
+//
+// usage: map-bench-rcu_read_scaling [keys] [millis per point]
+#include "map.hpp"
+#include "rcu_map.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+
+struct xorshift {
+	unsigned long long s;
+	unsigned long long operator()() {
+		s ^= s << 13;
+		s ^= s >> 7;
+		s ^= s << 17;
+		return s;
+	}
+};
+
+template<class Reader, class Writer>
+double run(int threads, int millis, Reader read, Writer write) {
+	std::atomic<bool> stop{false};
+	std::atomic<unsigned long long> total{0};
+	std::vector<std::thread> pool;
+	for (int t = 0; t < threads; ++t)
+		pool.emplace_back([&, t] {
+			xorshift rng{0x9e3779b97f4a7c15ull * (t + 1)};
+			unsigned long long ops = 0, sink = 0;
+			while (!stop.load(std::memory_order_relaxed)) {
+				for (int i = 0; i < 256; ++i) sink += read(rng());
+				ops += 256;
+			}
+			total += ops + (sink == 42);
+		});
+	std::thread writer([&] {
+		int round = 0;
+		while (!stop.load(std::memory_order_relaxed)) {
+			write(round++);
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+	});
+	auto start = clock_type::now();
+	std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+	stop = true;
+	for (auto &th : pool) th.join();
+	writer.join();
+	double sec = std::chrono::duration<double>(clock_type::now() - start).count();
+	return total.load() / sec;
+}
+
+int main(int argc, char **argv) {
+	int keys = argc > 1 ? std::atoi(argv[1]) : 1 << 16;
+	int millis = argc > 2 ? std::atoi(argv[2]) : 300;
+	int hw = (int) std::thread::hardware_concurrency();
+	if (hw <= 0) hw = 1;
+
+	sjtu::map<int, int> base;
+	for (int i = 0; i < keys; ++i) base[i] = i;
+	sjtu::rcu_map<int, int> rcu(base);
+	sjtu::map<int, int> locked(base);
+	std::mutex mtx;
+
+	printf("%8s %16s %16s %8s\n", "readers", "rcu ops/s", "mutex ops/s", "ratio");
+	for (int t = 1; t <= hw; t = t < hw && t * 2 > hw ? hw : t * 2) {
+		double r = run(
+				t, millis,
+				[&](unsigned long long x) { return rcu.count((int) (x % keys)); },
+				[&](int round) { rcu.assign(round % keys, round); });
+		double m = run(
+				t, millis,
+				[&](unsigned long long x) {
+					std::lock_guard<std::mutex> lock(mtx);
+					return locked.count((int) (x % keys));
+				},
+				[&](int round) {
+					std::lock_guard<std::mutex> lock(mtx);
+					locked[round % keys] = round;
+				});
+		printf("%8d %16.0f %16.0f %8.2f\n", t, r, m, r / m);
+		if (t == hw) break;
+	}
+	return 0;
+}
@@ -0,0 +1,83 @@
+// join/split set operations against the element-by-element loops they
+// replace, for a large map n and a second map of size m.
+//
+// usage: map-bench-set_ops [n] [threads]
+#include "fork_join.hpp"
+#include "map.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+using clock_type = std::chrono::steady_clock;
+using smap = sjtu::map<int, int>;
+
+unsigned long long seed = 88172645463325252ull;
+int Rand() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (int) (seed >> 33);
+}
+
+smap make(int n) {
+	smap m;
+	for (int i = 0; i < n; ++i) m[Rand()] = i;
+	return m;
+}
+
+template<class F>
+double ms(F f) {
+	auto start = clock_type::now();
+	f();
+	return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+	int threads = argc > 2 ? std::atoi(argv[2]) : (int) std::thread::hardware_concurrency();
+	sjtu::fork_join pool(threads);
+	smap big = make(n);
+
+	printf("%10s %10s | %12s %12s %12s | %12s %12s %12s\n", "n", "m",
+		   "union loop", "union join", "union par", "diff loop", "diff join", "diff par");
+	for (int m = n < 16 ? n : 16;; m = m * 16 < n ? m * 16 : n) {
+		smap small = make(m);
+		double t[6];
+		{
+			smap a(big);
+			t[0] = ms([&] {
+				for (auto it = small.cbegin(); it != small.cend(); ++it) a.insert(*it);
+			});
+		}
+		{
+			smap a(big);
+			t[1] = ms([&] { a.union_with(small); });
+		}
+		{
+			smap a(big);
+			t[2] = ms([&] { a.union_with(small, pool); });
+		}
+		{
+			smap a(big);
+			t[3] = ms([&] {
+				for (auto it = small.cbegin(); it != small.cend(); ++it) {
+					auto pos = a.find(it->first);
+					if (pos != a.end()) a.erase(pos);
+				}
+			});
+		}
+		{
+			smap a(big);
+			t[4] = ms([&] { a.difference_with(small); });
+		}
+		{
+			smap a(big);
+			t[5] = ms([&] { a.difference_with(small, pool); });
+		}
+		printf("%10d %10d | %10.2fms %10.2fms %10.2fms | %10.2fms %10.2fms %10.2fms\n",
+			   n, m, t[0], t[1], t[2], t[3], t[4], t[5]);
+		if (m == n) break;
+	}
+	return 0;
+}
@@ -0,0 +1,71 @@
+#include "arena.hpp"
+#include "map.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+
+// counts what goes through it, to see that the map allocates from the
+// default resource and gives everything back.
+struct counting_resource : sjtu::memory_resource {
+	long live = 0, calls = 0;
+
+protected:
+	void *do_allocate(size_t bytes, size_t align) override {
+		++live, ++calls;
+		return sjtu::new_delete_resource()->allocate(bytes, align);
+	}
+	void do_deallocate(void *p, size_t bytes, size_t align) noexcept override {
+		--live;
+		sjtu::new_delete_resource()->deallocate(p, bytes, align);
+	}
+};
+
+using arena_map = sjtu::map<int, std::string, std::less<int>, sjtu::polymorphic_allocator>;
+
+// one request: random inserts and erases checked against std::map.
+bool Request(unsigned seed)
+{
+	srand(seed);
+	arena_map m;
+	std::map<int, std::string> ref;
+	for (int i = 0; i < 20000; ++i) {
+		int k = rand() % 5000;
+		if (rand() % 3) {
+			m[k] = std::to_string(i);
+			ref[k] = std::to_string(i);
+		} else if (ref.erase(k)) {
+			m.erase(m.find(k));
+		}
+	}
+	arena_map copy(m);
+	if (copy.size() != ref.size()) return false;
+	auto it = copy.cbegin();
+	for (auto &[k, v] : ref) {
+		if (it->first != k || it->second != v) return false;
+		++it;
+	}
+	return it == copy.cend();
+}
+
+int main()
+{
+	bool ok = true;
+	sjtu::arena a(1 << 16);
+	for (unsigned seed = 0; seed < 5; ++seed) {
+		{
+			sjtu::resource_scope scope(&a);
+			ok &= Request(seed);
+		}
+		a.release();
+	}
+	counting_resource counter;
+	{
+		sjtu::resource_scope scope(&counter);
+		ok &= Request(7);
+	}
+	ok &= counter.calls && !counter.live;
+	ok &= sjtu::get_default_resource() == sjtu::new_delete_resource();
+	puts(ok ? "ok" : "failed");
+	return 0;
+}
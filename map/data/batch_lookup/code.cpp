@@ -0,0 +1,62 @@
+#include "map.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+unsigned seed = 19260817;
+int Rand() { return (seed = seed * 1103515245 + 12345) >> 8; }
+
+struct by_length {
+	bool operator()(const std::string &a, const std::string &b) const {
+		return a.size() != b.size() ? a.size() < b.size() : a < b;
+	}
+};
+
+template<class Map, class Key, class Compare = std::less<Key>>
+bool check(Map &m, std::vector<Key> keys, Compare cmp = Compare{}) {
+	bool ok = true;
+	const Map &cm = m;
+	std::vector<typename Map::iterator> its(keys.size());
+	std::vector<typename Map::const_iterator> cits(keys.size());
+	std::vector<char> has(keys.size());
+	m.find_batch(keys.begin(), keys.end(), its.begin());
+	cm.find_batch(keys.begin(), keys.end(), cits.begin());
+	cm.contains_batch(keys.begin(), keys.end(), has.begin());
+	for (size_t i = 0; i < keys.size(); ++i)
+		ok &= its[i] == m.find(keys[i]) && cits[i] == cm.find(keys[i]) && has[i] == (int) m.count(keys[i]);
+
+	std::sort(keys.begin(), keys.end(), cmp);
+	auto end = m.find_batch_sorted(keys.begin(), keys.end(), its.begin());
+	ok &= end == its.end();
+	cm.contains_batch_sorted(keys.begin(), keys.end(), has.begin());
+	for (size_t i = 0; i < keys.size(); ++i)
+		ok &= its[i] == m.find(keys[i]) && has[i] == (int) m.count(keys[i]);
+	return ok;
+}
+
+int main() {
+	sjtu::map<int, int> a;
+	for (int i = 0; i < 50000; ++i) a[Rand() % 100000] = i;
+	bool ok = true;
+	for (int n : {0, 1, 15, 16, 17, 32, 256, 5000}) {
+		std::vector<int> keys;
+		for (int i = 0; i < n; ++i) keys.push_back(Rand() % 100000);
+		if (n > 2) keys[1] = keys[0];
+		ok &= check(a, keys);
+	}
+	sjtu::map<int, int> empty;
+	ok &= check(empty, std::vector<int>{1, 2, 3});
+	printf("Test 1: find_batch / contains_batch on int keys %s\n", ok ? "PASSED" : "FAILED");
+
+	sjtu::map<std::string, int, by_length> b;
+	for (int i = 0; i < 3000; ++i) b[std::to_string(Rand() % 10000)] = i;
+	ok = true;
+	for (int n : {1, 16, 100, 1000}) {
+		std::vector<std::string> keys;
+		for (int i = 0; i < n; ++i) keys.push_back(std::to_string(Rand() % 10000));
+		ok &= check(b, keys, by_length{});
+	}
+	printf("Test 2: the same with a custom Compare %s\n", ok ? "PASSED" : "FAILED");
+	return 0;
+}
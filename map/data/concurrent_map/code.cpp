@@ -0,0 +1,82 @@
+#include "concurrent_map.hpp"
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <thread>
+#include <vector>
+
+void test_basic() {
+	sjtu::concurrent_map<int, int> m;
+	std::map<int, int> std_map;
+	bool ok = m.empty() && m.begin() == m.end();
+	unsigned seed = 233;
+	for (int i = 0; i < 20000; ++i) {
+		seed = seed * 1103515245 + 12345;
+		int key = (seed >> 8) % 5000, op = (seed >> 4) % 3;
+		if (op == 0) {
+			auto r = m.insert({key, i});
+			auto s = std_map.insert({key, i});
+			ok &= r.second == s.second && r.first->second == s.first->second;
+		}
+		else if (op == 1)
+			ok &= m.erase(key) == std_map.erase(key);
+		else {
+			auto it = m.lower_bound(key);
+			auto jt = std_map.lower_bound(key);
+			ok &= (it == m.end()) == (jt == std_map.end());
+			if (jt != std_map.end()) ok &= it->first == jt->first && it->second == jt->second;
+			ok &= m.count(key) == std_map.count(key);
+		}
+	}
+	ok &= m.size() == std_map.size();
+	auto jt = std_map.begin();
+	for (auto it = m.begin(); it != m.end(); ++it, ++jt)
+		ok &= jt != std_map.end() && it->first == jt->first && it->second == jt->second;
+	ok &= jt == std_map.end();
+	try {
+		++m.end();
+		ok = false;
+	} catch (sjtu::invalid_iterator &) {}
+	printf("Test 1: sequential operations against std::map %s\n", ok ? "PASSED" : "FAILED");
+}
+
+// each thread owns the keys congruent to its id, so the final contents are
+// known, while all threads still race on the same towers.
+void test_concurrent() {
+	const int threads = 4, per_thread = 20000;
+	sjtu::concurrent_map<int, int> m;
+	std::atomic<bool> ok{true};
+	std::vector<std::thread> pool;
+	for (int t = 0; t < threads; ++t)
+		pool.emplace_back([&, t] {
+			for (int i = 0; i < per_thread; ++i) {
+				int key = i * threads + t;
+				if (!m.insert({key, key}).second) ok = false;
+			}
+			for (int i = 0; i < per_thread; i += 2) {
+				int key = i * threads + t;
+				if (m.erase(key) != 1 || m.erase(key) != 0) ok = false;
+			}
+			for (int i = 1; i < per_thread; i += 2) {
+				int key = i * threads + t;
+				auto it = m.find(key);
+				if (it == m.end() || it->second != key) ok = false;
+			}
+		});
+	for (auto &th : pool) th.join();
+	int expect = 0;
+	size_t n = 0;
+	for (auto it = m.begin(); it != m.end(); ++it, ++n) {
+		while (expect / threads % 2 == 0) ++expect;
+		if (it->first != expect) ok = false;
+		++expect;
+	}
+	printf("Test 2: concurrent insert/erase/find %s\n",
+		   ok && n == threads * per_thread / 2 && m.size() == n ? "PASSED" : "FAILED");
+}
+
+int main() {
+	test_basic();
+	test_concurrent();
+	return 0;
+}
@@ -0,0 +1,44 @@
+// built with -fno-exceptions: failed checks abort instead of throwing.
+#define SJTU_NO_EXCEPTIONS
+#include "concurrent_map.hpp"
+#include "map.hpp"
+#include "rcu_map.hpp"
+#include <csignal>
+#include <cstdio>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// run f in a child process and report whether it aborted.
+template<class F>
+bool aborts(F f) {
+	fflush(stdout);
+	pid_t pid = fork();
+	if (pid == 0) {
+		freopen("/dev/null", "w", stderr);
+		f();
+		_exit(0);
+	}
+	int status = 0;
+	waitpid(pid, &status, 0);
+	return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
+
+int main() {
+	sjtu::map<int, int> m;
+	sjtu::concurrent_map<int, int> cm;
+	for (int i = 0; i < 1000; ++i) {
+		m[i] = i * 2;
+		cm.insert({i, i * 2});
+	}
+	bool ok = m.size() == 1000 && m.at(10) == 20 && cm.count(999) && !cm.count(1000);
+	m.erase(m.find(10));
+	ok &= m.find(10) == m.end();
+	printf("Test 1: maps without exceptions %s\n", ok ? "PASSED" : "FAILED");
+
+	ok = aborts([&] { m.at(10); });
+	ok &= aborts([&] { m.erase(m.end()); });
+	ok &= aborts([&] { ++m.end(); });
+	ok &= !aborts([&] { m.at(11); });
+	printf("Test 2: failed checks abort %s\n", ok ? "PASSED" : "FAILED");
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include "map.hpp"
+#include "utility.hpp"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+struct Heavy {
+	static int copies, moves;
+	std::string s;
+	Heavy() = default;
+	Heavy(const char *p) : s(p) {}
+	Heavy(const Heavy &o) : s(o.s) { ++copies; }
+	Heavy(Heavy &&o) noexcept : s(std::move(o.s)) { ++moves; }
+	Heavy &operator=(const Heavy &o) = default;
+	Heavy &operator=(Heavy &&o) = default;
+};
+int Heavy::copies = 0, Heavy::moves = 0;
+
+// neither copyable nor movable: only piecewise construction can build it in a pair.
+struct Pinned {
+	int a, b;
+	Pinned(int a, int b) : a(a), b(b) {}
+	Pinned(const Pinned &) = delete;
+};
+
+struct Explicit {
+	explicit Explicit(int) {}
+};
+
+static_assert(std::is_trivially_copyable_v<sjtu::pair<int, double>>);
+static_assert(std::is_trivially_copyable_v<sjtu::pair<const int, long>>);
+static_assert(!std::is_trivially_copyable_v<sjtu::pair<int, std::string>>);
+static_assert(std::is_convertible_v<sjtu::pair<int, int>, sjtu::pair<long, long>>);
+static_assert(!std::is_convertible_v<sjtu::pair<int, int>, sjtu::pair<Explicit, int>>);
+static_assert(std::is_constructible_v<sjtu::pair<Explicit, int>, sjtu::pair<int, int>>);
+static_assert(std::tuple_size_v<sjtu::pair<int, char>> == 2);
+static_assert(std::is_same_v<std::tuple_element_t<1, sjtu::pair<int, char>>, char>);
+
+void test_forwarding() {
+	bool ok = true;
+	Heavy h("payload");
+	Heavy::copies = Heavy::moves = 0;
+	sjtu::pair<int, Heavy> a(1, std::move(h));
+	ok &= Heavy::copies == 0 && Heavy::moves == 1 && a.second.s == "payload";
+	sjtu::pair<long, Heavy> b(std::move(a));
+	ok &= Heavy::copies == 0 && Heavy::moves == 2 && b.second.s == "payload";
+	sjtu::pair<long, Heavy> c(b);
+	ok &= Heavy::copies == 1 && c.second.s == "payload";
+	sjtu::pair<int, std::unique_ptr<int>> u(1, std::make_unique<int>(7));
+	sjtu::pair<int, std::unique_ptr<int>> v(std::move(u));
+	ok &= !u.second && *v.second == 7;
+	u = std::move(v);
+	ok &= *u.second == 7;
+	printf("Test 1: forwarding and converting constructors %s\n", ok ? "PASSED" : "FAILED");
+}
+
+void test_piecewise() {
+	sjtu::pair<Pinned, std::string> p(std::piecewise_construct, std::forward_as_tuple(3, 4), std::forward_as_tuple(5, 'x'));
+	bool ok = p.first.a == 3 && p.first.b == 4 && p.second == "xxxxx";
+	Heavy h("moved");
+	Heavy::copies = 0;
+	sjtu::pair<Heavy, int> q(std::piecewise_construct, std::forward_as_tuple(std::move(h)), std::tuple<>());
+	ok &= Heavy::copies == 0 && q.first.s == "moved" && q.second == 0;
+	printf("Test 2: piecewise construction %s\n", ok ? "PASSED" : "FAILED");
+}
+
+void test_bindings() {
+	sjtu::pair<int, std::string> p(1, "one");
+	auto &[k, v] = p;
+	v += "!";
+	bool ok = k == 1 && p.second == "one!";
+	const auto &[ck, cv] = p;
+	ok &= ck == 1 && cv == "one!";
+	auto [mk, mv] = std::move(p);
+	ok &= mk == 1 && mv == "one!";
+	ok &= sjtu::get<0>(sjtu::pair<int, char>(2, 'c')) == 2;
+	sjtu::map<int, int> m;
+	for (int i = 0; i < 10; ++i) m.insert({i, i * i});
+	int sum = 0;
+	for (auto &[key, value] : m) sum += key * value;
+	ok &= sum == 2025;
+	printf("Test 3: structured bindings %s\n", ok ? "PASSED" : "FAILED");
+}
+
+void test_map_insert() {
+	sjtu::map<int, Heavy> m;
+	Heavy::copies = 0;
+	m.insert({1, Heavy("a")});
+	m[2] = Heavy("b");
+	Heavy h("c");
+	m.insert({3, std::move(h)});
+	bool ok = Heavy::copies == 0 && m.size() == 3 && m[1].s == "a" && m[2].s == "b" && m[3].s == "c";
+	// an existing key leaves the map alone
+	ok &= !m.insert({1, Heavy("z")}).second && m[1].s == "a";
+	printf("Test 4: map::insert moves the value %s\n", ok ? "PASSED" : "FAILED");
+}
+
+int main() {
+	test_forwarding();
+	test_piecewise();
+	test_bindings();
+	test_map_insert();
+	return 0;
+}
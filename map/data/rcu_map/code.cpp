@@ -0,0 +1,66 @@
+#include "rcu_map.hpp"
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// every published version holds keys [0, n) with value key * 2 for some n,
+// so a reader can check that it never sees a half-applied update.
+bool check_snapshot(const sjtu::rcu_map<int, long long>::snapshot &s) {
+	int expect = 0;
+	for (auto it = s.begin(); it != s.end(); ++it, ++expect)
+		if (it->first != expect || it->second != expect * 2ll) return false;
+	return (size_t) expect == s.size();
+}
+
+void test_basic() {
+	sjtu::rcu_map<int, int> m;
+	bool ok = m.empty();
+	for (int i = 0; i < 100; ++i) ok &= m.insert({i, i * i});
+	ok &= !m.insert({5, 0});
+	ok &= m.size() == 100 && m.at(7) == 49 && m.count(100) == 0;
+	auto old = m.read();
+	m.assign(7, -1);
+	ok &= m.erase(8) == 1 && m.erase(8) == 0;
+	ok &= old.at(7) == 49 && old.count(8) == 1 && old.size() == 100;
+	ok &= m.at(7) == -1 && m.count(8) == 0 && m.size() == 99;
+	try {
+		m.at(1000);
+		ok = false;
+	} catch (sjtu::index_out_of_bound &) {}
+	try {
+		m.update([](sjtu::map<int, int> &x) {
+			x.clear();
+			throw sjtu::runtime_error{};
+		});
+		ok = false;
+	} catch (sjtu::runtime_error &) {}
+	ok &= m.size() == 99;
+	m.clear();
+	ok &= m.empty() && old.size() == 100;
+	printf("Test 1: single thread semantics %s\n", ok ? "PASSED" : "FAILED");
+}
+
+void test_concurrent() {
+	sjtu::rcu_map<int, long long> m;
+	std::atomic<bool> stop{false}, ok{true};
+	std::vector<std::thread> readers;
+	for (int t = 0; t < 4; ++t)
+		readers.emplace_back([&] {
+			while (!stop.load()) {
+				auto s = m.read();
+				if (!check_snapshot(s)) ok = false;
+			}
+		});
+	for (int n = 0; n < 2000; ++n)
+		m.update([n](sjtu::map<int, long long> &x) { x[n] = n * 2ll; });
+	stop = true;
+	for (auto &th : readers) th.join();
+	printf("Test 2: concurrent readers see whole versions %s\n", ok && m.size() == 2000 ? "PASSED" : "FAILED");
+}
+
+int main() {
+	test_basic();
+	test_concurrent();
+	return 0;
+}
@@ -0,0 +1,140 @@
+#include "fork_join.hpp"
+#include "map.hpp"
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <thread>
+
+unsigned seed = 2023;
+int Rand() { return (seed = seed * 1103515245 + 12345) >> 8; }
+
+using smap = sjtu::map<int, int>;
+using stdmap = std::map<int, int>;
+
+void fill(smap &a, stdmap &b, int n, int range, int tag) {
+	for (int i = 0; i < n; ++i) {
+		int k = Rand() % range;
+		a.insert({k, tag});
+		b.insert({k, tag});
+	}
+}
+
+// compare contents both ways, so the parent links are checked as well.
+bool same(const smap &a, const stdmap &b) {
+	if (a.size() != b.size()) return false;
+	auto jt = b.begin();
+	for (auto it = a.cbegin(); it != a.cend(); ++it, ++jt)
+		if (it->first != jt->first || it->second != jt->second) return false;
+	if (b.empty()) return true;
+	auto rt = b.rbegin();
+	auto it = a.cend();
+	do {
+		--it;
+		if (it->first != rt->first) return false;
+		++rt;
+	} while (it != a.cbegin());
+	return true;
+}
+
+// the result must still be a working red-black tree.
+bool still_works(smap &a, stdmap &b) {
+	for (int i = 0; i < 2000; ++i) {
+		int k = Rand() % 100000;
+		if (i & 1) {
+			auto it = a.find(k);
+			if ((it == a.end()) != (b.count(k) == 0)) return false;
+			if (it != a.end()) a.erase(it), b.erase(k);
+		}
+		else
+			a[k] = k, b[k] = k;
+	}
+	return same(a, b);
+}
+
+// frees only on the thread that made it, as an arena would need.
+std::thread::id main_thread;
+std::atomic<bool> foreign_free{false};
+template<class T>
+struct one_thread_allocator : std::allocator<T> {
+	void deallocate(T *p, size_t n) {
+		if (std::this_thread::get_id() != main_thread) foreign_free = true;
+		std::allocator<T>::deallocate(p, n);
+	}
+};
+
+template<class Fork>
+bool round(int n, int m, Fork &fork) {
+	bool ok = true;
+	smap a, b;
+	stdmap sa, sb;
+	fill(a, sa, n, 100000, 1);
+	fill(b, sb, m, 100000, 2);
+
+	smap u(a);
+	u.union_with(b, fork);
+	stdmap su(sa);
+	su.insert(sb.begin(), sb.end());
+	ok &= same(u, su) && same(b, sb);
+
+	smap x(a);
+	x.intersect_with(b, fork);
+	stdmap sx;
+	for (auto &p : sa)
+		if (sb.count(p.first)) sx.insert(p);
+	ok &= same(x, sx);
+
+	smap d(a);
+	d.difference_with(b, fork);
+	stdmap sd;
+	for (auto &p : sa)
+		if (!sb.count(p.first)) sd.insert(p);
+	ok &= same(d, sd);
+
+	int key = Rand() % 100000;
+	smap hi = a.split_at(key);
+	stdmap shi(sa.lower_bound(key), sa.end());
+	sa.erase(sa.lower_bound(key), sa.end());
+	ok &= same(a, sa) && same(hi, shi);
+
+	smap moved(b);
+	hi.union_with(std::move(moved), fork);
+	shi.insert(sb.begin(), sb.end());
+	ok &= same(hi, shi) && moved.empty();
+
+	ok &= still_works(u, su) && still_works(x, sx) && still_works(d, sd);
+	ok &= still_works(a, sa) && still_works(hi, shi);
+	return ok;
+}
+
+int main() {
+	sjtu::sequential_fork seq;
+	sjtu::fork_join par(4, 256);
+	const int sizes[][2] = {{0, 0}, {0, 50}, {50, 0}, {1, 1}, {10, 5000}, {5000, 10}, {3000, 3000}, {20000, 20000}};
+	bool ok = true;
+	for (auto &s : sizes) ok &= round(s[0], s[1], seq);
+	printf("Test 1: union/intersect/difference/split_at %s\n", ok ? "PASSED" : "FAILED");
+	ok = true;
+	for (auto &s : sizes) ok &= round(s[0], s[1], par);
+	printf("Test 2: the same on fork_join %s\n", ok ? "PASSED" : "FAILED");
+	smap self;
+	stdmap sself;
+	fill(self, sself, 100, 1000, 3);
+	self.union_with(self);
+	self.intersect_with(self);
+	ok = same(self, sself);
+	self.difference_with(self);
+	ok &= self.empty();
+	printf("Test 3: operations with itself %s\n", ok ? "PASSED" : "FAILED");
+	main_thread = std::this_thread::get_id();
+	sjtu::map<int, int, std::less<int>, one_thread_allocator> a, b;
+	for (int i = 0; i < 20000; ++i) a[Rand() % 30000] = i, b[Rand() % 30000] = i;
+	sjtu::map<int, int, std::less<int>, one_thread_allocator> x(a), d(a);
+	x.intersect_with(b, par);
+	d.difference_with(b, par);
+	size_t na = a.size(), nb = b.size();
+	a.union_with(std::move(b), par);
+	ok = a.size() == na + nb - x.size() && d.size() == na - x.size() && !foreign_free;
+	printf("Test 4: nodes freed on the calling thread %s\n", ok ? "PASSED" : "FAILED");
+	return 0;
+}
@@ -0,0 +1,39 @@
+#define SJTU_STATS
+#include "map.hpp"
+#include <cmath>
+#include <cstdio>
+
+using sjtu::stats_registry;
+
+int main()
+{
+	bool ok = true;
+	const int n = 1 << 14;
+	sjtu::map<int, int> a, b;
+	for (int i = 0; i < n; ++i) a[i] = i;
+	for (int i = n; i > 0; --i) b[i * 7919 % n] = i;
+	// sequential inserts rotate all the time; a red-black tree stays within 2 log2(n + 1) levels.
+	ok &= a.stats().rotations > n / 2 && a.stats().recolours > n / 2;
+	ok &= a.stats().height <= 2 * std::log2(n + 1) && b.stats().height <= 2 * std::log2(n + 1);
+	ok &= a.stats().height >= std::log2(n);
+
+	size_t rotations = a.stats().rotations;
+	for (int i = 0; i < n; i += 2) a.erase(a.find(i));
+	ok &= a.stats().rotations > rotations;
+
+	// the registry sums the rotations of both maps and keeps the larger height.
+	ok &= stats_registry::value("map.rotations") == a.stats().rotations + b.stats().rotations;
+	ok &= stats_registry::value("map.recolours") == a.stats().recolours + b.stats().recolours;
+	size_t h = a.stats().height > b.stats().height ? a.stats().height : b.stats().height;
+	ok &= stats_registry::value("map.height") == h;
+	ok &= stats_registry::find("vector.reallocations") == nullptr;
+
+	sjtu::map<int, int> c(a);
+	ok &= c.stats().rotations == 0;
+	stats_registry::reset();
+	ok &= stats_registry::value("map.rotations") == 0 && a.stats().rotations > 0;
+
+	stats_registry::for_each([](const char *name, size_t) { puts(name); });
+	puts(ok ? "ok" : "failed");
+	return 0;
+}
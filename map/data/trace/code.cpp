@@ -0,0 +1,82 @@
+#include "recorded_map.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+using sjtu::trace_reader;
+
+int main()
+{
+	bool ok = true;
+	const char *path = "map-trace.bin";
+	const int n = 100000;
+	{
+		// 400000 records, past the first window of the writer.
+		sjtu::recorded_map<int, int> m(path);
+		ok &= m.trace().ok();
+		for (int i = 0; i < n; ++i) m[i - n / 2] = i;
+		for (int i = 0; i < n; ++i) ok &= m.find(i - n / 2)->second == i;
+		for (int i = 0; i < n; ++i) m.erase(m.find(i - n / 2));
+		ok &= m.empty() && m.trace().count() == 4 * n;
+		m.insert({7, 7});
+		m.clear();
+	}
+	{
+		trace_reader t(path);
+		ok &= t.ok() && t.kind() == sjtu::trace_kind::map && t.size() == 4 * n + 2;
+		const uint64_t *r = t.records();
+		// signed keys keep their order.
+		for (int i = 0; i < n; ++i) ok &= trace_reader::op(r[i]) == sjtu::trace_assign;
+		for (int i = 1; i < n; ++i) ok &= trace_reader::key(r[i - 1]) < trace_reader::key(r[i]);
+		ok &= trace_reader::key(r[n / 2]) == sjtu::trace_key(0) && trace_reader::key(r[0]) == sjtu::trace_key(-n / 2);
+		ok &= trace_reader::op(r[n]) == sjtu::trace_find && trace_reader::op(r[2 * n]) == sjtu::trace_find;
+		ok &= trace_reader::op(r[2 * n + 1]) == sjtu::trace_erase && trace_reader::key(r[2 * n + 1]) == trace_reader::key(r[n]);
+		ok &= trace_reader::op(r[4 * n]) == sjtu::trace_insert && r[4 * n] == sjtu::trace_key(7);
+		ok &= trace_reader::op(r[4 * n + 1]) == sjtu::trace_clear;
+	}
+	{
+		// a string key is hashed, the same string the same way.
+		sjtu::recorded_map<std::string, int> m(path);
+		m["a"] = 1;
+		m.count("a");
+		m.count("b");
+	}
+	{
+		trace_reader t(path);
+		ok &= t.ok() && t.size() == 3;
+		ok &= t.records()[0] << 4 == t.records()[1] << 4 && t.records()[1] != t.records()[2];
+	}
+	{
+		// a count past the end of the file, even one that overflows the size, or an unknown kind.
+		sjtu::recorded_map<int, int> m(path);
+		m[1] = 1;
+	}
+	auto patch = [&](size_t offset, const void *bytes, size_t n) {
+		FILE *f = fopen(path, "r+b");
+		fseek(f, (long) offset, SEEK_SET);
+		fwrite(bytes, 1, n, f);
+		fclose(f);
+	};
+	ok &= trace_reader(path).ok();
+	for (uint64_t count : {uint64_t(2), uint64_t(1) << 61, ~uint64_t(0)}) {
+		patch(offsetof(sjtu::trace_header, count), &count, sizeof count);
+		ok &= !trace_reader(path).ok();
+	}
+	uint64_t one = 1;
+	patch(offsetof(sjtu::trace_header, count), &one, sizeof one);
+	for (uint8_t kind : {0, 4, 255}) {
+		patch(offsetof(sjtu::trace_header, kind), &kind, 1);
+		ok &= !trace_reader(path).ok();
+	}
+	uint8_t map_kind = uint8_t(sjtu::trace_kind::map);
+	patch(offsetof(sjtu::trace_header, kind), &map_kind, 1);
+	ok &= trace_reader(path).ok();
+	unlink(path);
+	ok &= !trace_reader(path).ok();
+	sjtu::recorded_map<int, int> broken("no-such-dir/map-trace.bin");
+	broken[1] = 1;
+	ok &= !broken.trace().ok() && broken.at(1) == 1;
+	puts(ok ? "ok" : "failed");
+	return 0;
+}
@@ -0,0 +1,203 @@
+#ifndef SJTU_ARENA_HPP
+#define SJTU_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace sjtu {
+
+/**
+ * where a polymorphic_allocator gets its memory from, like
+ * std::pmr::memory_resource.
+ */
+class memory_resource {
+public:
+	static constexpr size_t max_align = alignof(std::max_align_t);
+
+	virtual ~memory_resource() = default;
+
+	void *allocate(size_t bytes, size_t align = max_align) { return do_allocate(bytes, align); }
+	void deallocate(void *p, size_t bytes, size_t align = max_align) noexcept { do_deallocate(p, bytes, align); }
+
+protected:
+	virtual void *do_allocate(size_t bytes, size_t align) = 0;
+	virtual void do_deallocate(void *p, size_t bytes, size_t align) noexcept = 0;
+};
+
+// ::operator new and ::operator delete.
+inline memory_resource *new_delete_resource() noexcept {
+	class resource : public memory_resource {
+	protected:
+		void *do_allocate(size_t bytes, size_t align) override {
+			if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) return ::operator new(bytes);
+			return ::operator new(bytes, std::align_val_t{align});
+		}
+		void do_deallocate(void *p, size_t, size_t align) noexcept override {
+			if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) return ::operator delete(p);
+			::operator delete(p, std::align_val_t{align});
+		}
+	};
+	static resource instance;
+	return &instance;
+}
+
+/**
+ * a monotonic buffer resource: allocation bumps a pointer through a chunk,
+ * deallocation does nothing, and release frees every chunk at once. Chunks
+ * double in size, starting after the buffer passed in, if any.
+ *
+ * Meant for request-scoped work: build the containers of one request on an
+ * arena, destroy them, then release or reset it before the next request.
+ * reset keeps the largest chunk, so that requests of a steady size stop
+ * calling operator new at all. An arena must outlive the containers using
+ * it, and is not thread-safe.
+ */
+class arena : public memory_resource {
+public:
+	explicit arena(size_t first_chunk = 4096) noexcept
+		: _first_size(first_chunk ? first_chunk : 1), _next_size(_first_size) {}
+	arena(void *buffer, size_t size) noexcept
+		: _buffer(buffer), _buffer_size(size), _cur(buffer), _left(size),
+		  _first_size(size ? 2 * size : 1), _next_size(_first_size) {}
+	arena(const arena &) = delete;
+	arena &operator=(const arena &) = delete;
+	~arena() override { release(); }
+
+	// free every chunk; everything allocated so far is gone.
+	void release() noexcept {
+		while (_chunks) {
+			chunk *nx = _chunks->next;
+			::operator delete(static_cast<void *>(_chunks));
+			_chunks = nx;
+		}
+		_cur = _buffer;
+		_left = _buffer_size;
+		_next_size = _first_size;
+	}
+	// free every chunk but the newest, the largest, and start over in it.
+	void reset() noexcept {
+		if (!_chunks) return release();
+		chunk *keep = _chunks;
+		_chunks = keep->next;
+		release();
+		keep->next = nullptr;
+		_chunks = keep;
+		_cur = keep + 1;
+		_left = keep->size;
+		_next_size = 2 * keep->size;
+	}
+
+protected:
+	void *do_allocate(size_t bytes, size_t align) override {
+		if (!_cur || !std::align(align, bytes, _cur, _left)) {
+			grow(bytes + align);
+			std::align(align, bytes, _cur, _left);
+		}
+		void *p = _cur;
+		_cur = static_cast<char *>(_cur) + bytes;
+		_left -= bytes;
+		return p;
+	}
+	void do_deallocate(void *, size_t, size_t) noexcept override {}
+
+private:
+	struct alignas(std::max_align_t) chunk {
+		chunk *next;
+		size_t size;
+	};
+
+	void *_buffer = nullptr;
+	size_t _buffer_size = 0;
+	chunk *_chunks = nullptr;
+	void *_cur = nullptr;
+	size_t _left = 0;
+	size_t _first_size, _next_size;
+
+	void grow(size_t need) {
+		size_t size = _next_size < need ? need : _next_size;
+		chunk *c = static_cast<chunk *>(::operator new(sizeof(chunk) + size));
+		c->next = _chunks;
+		c->size = size;
+		_chunks = c;
+		_cur = c + 1;
+		_left = size;
+		_next_size = 2 * size;
+	}
+};
+
+/**
+ * the resource a default-constructed polymorphic_allocator takes, per
+ * thread; new_delete_resource() unless set. set_default_resource returns
+ * the previous one.
+ */
+inline memory_resource *&default_resource_slot() noexcept {
+	thread_local memory_resource *current = new_delete_resource();
+	return current;
+}
+inline memory_resource *get_default_resource() noexcept { return default_resource_slot(); }
+inline memory_resource *set_default_resource(memory_resource *r) noexcept {
+	memory_resource *old = default_resource_slot();
+	default_resource_slot() = r ? r : new_delete_resource();
+	return old;
+}
+
+/**
+ * makes r the default resource of this thread until the end of the scope.
+ * The containers construct their allocators themselves, so this is how
+ * they are put on an arena:
+ *
+ *     sjtu::arena a;
+ *     sjtu::resource_scope scope(&a);
+ *     sjtu::map<int, int, std::less<int>, sjtu::polymorphic_allocator> m;
+ */
+class resource_scope {
+public:
+	explicit resource_scope(memory_resource *r) noexcept : _old(set_default_resource(r)) {}
+	resource_scope(const resource_scope &) = delete;
+	resource_scope &operator=(const resource_scope &) = delete;
+	~resource_scope() { set_default_resource(_old); }
+
+private:
+	memory_resource *_old;
+};
+
+/**
+ * an allocator that forwards to a memory_resource, fixed when it is
+ * constructed: the default resource of the thread unless one is given.
+ * It fits the Alloc parameter of vector (as polymorphic_allocator<T>), and
+ * of map and priority_queue (as polymorphic_allocator). Two allocators
+ * are equal when they share a resource; containers that exchange nodes,
+ * like priority_queue::merge, must use equal ones.
+ */
+template<typename Type>
+class polymorphic_allocator {
+public:
+	using value_type = Type;
+
+	polymorphic_allocator() noexcept : _resource(get_default_resource()) {}
+	polymorphic_allocator(memory_resource *r) noexcept : _resource(r) {}
+	template<typename Other>
+	polymorphic_allocator(const polymorphic_allocator<Other> &other) noexcept : _resource(other.resource()) {}
+
+	Type *allocate(size_t n) {
+		return static_cast<Type *>(_resource->allocate(n * sizeof(Type), alignof(Type)));
+	}
+	void deallocate(Type *p, size_t n) noexcept {
+		_resource->deallocate(p, n * sizeof(Type), alignof(Type));
+	}
+
+	memory_resource *resource() const noexcept { return _resource; }
+
+	template<typename Other>
+	bool operator==(const polymorphic_allocator<Other> &rhs) const noexcept { return _resource == rhs.resource(); }
+	template<typename Other>
+	bool operator!=(const polymorphic_allocator<Other> &rhs) const noexcept { return _resource != rhs.resource(); }
+
+private:
+	memory_resource *_resource;
+};
+
+}// namespace sjtu
+
+#endif
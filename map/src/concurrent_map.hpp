@@ -0,0 +1,309 @@
+#ifndef SJTU_CONCURRENT_MAP_HPP
+#define SJTU_CONCURRENT_MAP_HPP
+
+#include "epoch.hpp"
+#include "exceptions.hpp"
+#include "utility.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+
+namespace sjtu {
+
+/**
+ * a lock-free ordered map (skip list), after Herlihy & Shavit.
+ *
+ * A node is erased by marking the low bit of its next pointers, top level
+ * first; marking level 0 is the linearisation point. Any traversal that
+ * meets a marked node snips it out with a CAS. Unlinked nodes are retired
+ * to the epoch domain, so a thread that is still walking over one keeps it
+ * alive.
+ *
+ * Every operation pins the epoch for its duration; iterators hold a pin
+ * of their own and must stay on the thread that created them. Iteration
+ * is weakly consistent: it never returns an element twice or out of
+ * order, and sees every element present for the whole traversal.
+ *
+ * Compare must not throw.
+ */
+template<class Key,
+		 class T,
+		 class Compare = std::less<Key>>
+class concurrent_map {
+public:
+	using value_type = pair<const Key, T>;
+	static constexpr int max_level = 32;
+
+private:
+	using link_type = std::atomic<uintptr_t>;
+
+	struct Node {
+		Node(const value_type &val, int h) : data(val), height(h) {}
+		value_type data;
+		int height;
+		// one reference for the inserting thread while it links the upper
+		// levels, one for membership; the last to drop it retires the node.
+		std::atomic<int> refs{2};
+	};
+
+	static constexpr size_t links_offset =
+			(sizeof(Node) + alignof(link_type) - 1) / alignof(link_type) * alignof(link_type);
+
+	static link_type *links(Node *n) {
+		return reinterpret_cast<link_type *>(reinterpret_cast<char *>(n) + links_offset);
+	}
+	static Node *ptr(uintptr_t v) { return reinterpret_cast<Node *>(v & ~uintptr_t(1)); }
+	static bool marked(uintptr_t v) { return v & 1; }
+
+	template<bool is_const>
+	class iterator_common {
+		friend class concurrent_map;
+		explicit iterator_common(Node *n) : _ptr(n) {}
+
+	public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = concurrent_map::value_type;
+		using pointer = typename std::conditional<is_const, const value_type *, value_type *>::type;
+		using reference = typename std::conditional<is_const, const value_type &, value_type &>::type;
+		using iterator_category = std::forward_iterator_tag;
+
+		iterator_common() = default;
+		iterator_common(const iterator_common<false> &it) : _guard(it._guard), _ptr(it._ptr) {}
+		bool operator==(const iterator_common &rhs) const { return _ptr == rhs._ptr; }
+		bool operator!=(const iterator_common &rhs) const { return _ptr != rhs._ptr; }
+		iterator_common operator++(int) {
+			iterator_common ret = *this;
+			++*this;
+			return ret;
+		}
+		iterator_common &operator++() {
+			if (!_ptr) SJTU_THROW(invalid_iterator);
+			_ptr = next_alive(ptr(links(_ptr)[0].load(std::memory_order_acquire)));
+			return *this;
+		}
+		reference operator*() const { return _ptr->data; }
+		pointer operator->() const noexcept { return &_ptr->data; }
+
+	private:
+		epoch_guard _guard;
+		Node *_ptr = nullptr;
+
+		template<bool>
+		friend class iterator_common;
+	};
+
+public:
+	using iterator = iterator_common<false>;
+	using const_iterator = iterator_common<true>;
+
+	concurrent_map() {
+		for (link_type &l : _head) l.store(0, std::memory_order_relaxed);
+	}
+	concurrent_map(const concurrent_map &) = delete;
+	concurrent_map &operator=(const concurrent_map &) = delete;
+	// no other thread may touch the map any more; erased nodes are already with the epoch domain.
+	~concurrent_map() {
+		Node *p = ptr(_head[0].load(std::memory_order_relaxed));
+		while (p) {
+			Node *nx = ptr(links(p)[0].load(std::memory_order_relaxed));
+			destroy(p);
+			p = nx;
+		}
+	}
+
+	iterator begin() {
+		epoch_guard g;
+		return iterator{next_alive(ptr(_head[0].load(std::memory_order_acquire)))};
+	}
+	const_iterator begin() const { return const_cast<concurrent_map *>(this)->begin(); }
+	const_iterator cbegin() const { return begin(); }
+	iterator end() { return iterator{nullptr}; }
+	const_iterator end() const { return const_iterator{nullptr}; }
+	const_iterator cend() const { return end(); }
+
+	// the counters are updated after the linearisation points, so these are only approximate under contention.
+	[[nodiscard]] bool empty() const { return !_size.load(std::memory_order_relaxed); }
+	[[nodiscard]] size_t size() const { return _size.load(std::memory_order_relaxed); }
+
+	iterator find(const Key &key) {
+		epoch_guard g;
+		Node *p = search(key);
+		return iterator{p && !_opt(key, p->data.first) ? p : nullptr};
+	}
+	const_iterator find(const Key &key) const { return const_cast<concurrent_map *>(this)->find(key); }
+	size_t count(const Key &key) const { return find(key) != end(); }
+
+	iterator lower_bound(const Key &key) {
+		epoch_guard g;
+		return iterator{search(key)};
+	}
+	const_iterator lower_bound(const Key &key) const { return const_cast<concurrent_map *>(this)->lower_bound(key); }
+
+	pair<iterator, bool> insert(const value_type &value) {
+		epoch_guard g;
+		link_type *preds[max_level];
+		Node *succs[max_level];
+		Node *n = nullptr;
+		while (true) {
+			if (locate(value.first, preds, succs)) {
+				if (n) destroy(n);
+				return {iterator{succs[0]}, false};
+			}
+			if (!n) n = create(value, random_level());
+			for (int l = 0; l < n->height; ++l)
+				links(n)[l].store(reinterpret_cast<uintptr_t>(succs[l]), std::memory_order_relaxed);
+			uintptr_t expected = reinterpret_cast<uintptr_t>(succs[0]);
+			if (preds[0][0].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(n), std::memory_order_release))
+				break;
+		}
+		_size.fetch_add(1, std::memory_order_relaxed);
+		link_upper(n, preds, succs);
+		return {iterator{n}, true};
+	}
+
+	size_t erase(const Key &key) {
+		epoch_guard g;
+		link_type *preds[max_level];
+		Node *succs[max_level];
+		if (!locate(key, preds, succs)) return 0;
+		Node *n = succs[0];
+		for (int l = n->height - 1; l > 0; --l) {
+			uintptr_t s = links(n)[l].load(std::memory_order_acquire);
+			while (!marked(s) && !links(n)[l].compare_exchange_weak(s, s | 1, std::memory_order_acq_rel)) {}
+		}
+		uintptr_t s = links(n)[0].load(std::memory_order_acquire);
+		while (true) {
+			if (marked(s)) return 0;
+			if (links(n)[0].compare_exchange_weak(s, s | 1, std::memory_order_acq_rel)) break;
+		}
+		_size.fetch_sub(1, std::memory_order_relaxed);
+		locate(key, preds, succs);
+		release_ref(n);
+		return 1;
+	}
+	void erase(const iterator &pos) {
+		if (!pos._ptr) SJTU_THROW(invalid_iterator);
+		erase(pos->first);
+	}
+
+private:
+	link_type _head[max_level];
+	std::atomic<size_t> _size{0};
+	[[no_unique_address]] Compare _opt;
+
+private:
+	static Node *create(const value_type &value, int h) {
+		void *mem = ::operator new(links_offset + sizeof(link_type) * h);
+		Node *n;
+		SJTU_TRY {
+			n = new (mem) Node{value, h};
+		} SJTU_CATCH_ALL {
+			::operator delete(mem);
+			SJTU_RETHROW;
+		}
+		for (int l = 0; l < h; ++l) new (links(n) + l) link_type(0);
+		return n;
+	}
+	static void destroy(Node *n) {
+		n->~Node();
+		::operator delete(static_cast<void *>(n));
+	}
+	static void release_ref(Node *n) {
+		if (n->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			epoch_domain::global().retire(n, [](void *p) { destroy(static_cast<Node *>(p)); });
+	}
+	static int random_level() {
+		thread_local unsigned long long s = 0x9e3779b97f4a7c15ull ^ reinterpret_cast<uintptr_t>(&s);
+		s ^= s << 13;
+		s ^= s >> 7;
+		s ^= s << 17;
+		int h = 1;
+		for (unsigned long long bits = s; (bits & 1) && h < max_level; bits >>= 1) ++h;
+		return h;
+	}
+	// skip marked nodes at level 0 without helping.
+	static Node *next_alive(Node *p) {
+		while (p) {
+			uintptr_t nx = links(p)[0].load(std::memory_order_acquire);
+			if (!marked(nx)) return p;
+			p = ptr(nx);
+		}
+		return nullptr;
+	}
+	/**
+	 * fill preds/succs with the position of key on every level, snipping
+	 * marked nodes on the way. succs[0] is the first live node not less
+	 * than key. Returns whether it is equal to key.
+	 */
+	bool locate(const Key &key, link_type **preds, Node **succs) {
+	retry:
+		link_type *pred = _head;
+		for (int l = max_level - 1; l >= 0; --l) {
+			Node *curr = ptr(pred[l].load(std::memory_order_acquire));
+			while (curr) {
+				uintptr_t succ = links(curr)[l].load(std::memory_order_acquire);
+				if (marked(succ)) {
+					uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+					if (!pred[l].compare_exchange_strong(expected, succ & ~uintptr_t(1), std::memory_order_acq_rel))
+						goto retry;
+					curr = ptr(succ);
+					continue;
+				}
+				if (!_opt(curr->data.first, key)) break;
+				pred = links(curr);
+				curr = ptr(succ);
+			}
+			preds[l] = pred;
+			succs[l] = curr;
+		}
+		return succs[0] && !_opt(key, succs[0]->data.first);
+	}
+
+	// read-only descent: first live node not less than key.
+	Node *search(const Key &key) const {
+		const link_type *pred = _head;
+		Node *curr = nullptr;
+		for (int l = max_level - 1; l >= 0; --l) {
+			curr = ptr(pred[l].load(std::memory_order_acquire));
+			while (curr) {
+				uintptr_t succ = links(curr)[l].load(std::memory_order_acquire);
+				if (marked(succ)) {
+					curr = ptr(succ);
+					continue;
+				}
+				if (!_opt(curr->data.first, key)) break;
+				pred = links(curr);
+				curr = ptr(succ);
+			}
+		}
+		return curr;
+	}
+
+	// link n on levels 1..height-1, giving up as soon as someone marks it.
+	void link_upper(Node *n, link_type **preds, Node **succs) {
+		const Key &key = n->data.first;
+		for (int l = 1; l < n->height; ++l) {
+			while (true) {
+				uintptr_t cur = links(n)[l].load(std::memory_order_acquire);
+				if (marked(cur)) goto done;
+				uintptr_t want = reinterpret_cast<uintptr_t>(succs[l]);
+				if (cur != want && !links(n)[l].compare_exchange_strong(cur, want, std::memory_order_acq_rel))
+					continue;
+				uintptr_t expected = want;
+				if (preds[l][l].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(n), std::memory_order_release))
+					break;
+				if (!locate(key, preds, succs) || succs[0] != n) goto done;
+			}
+		}
+	done:
+		// an eraser may have run its unlinking pass before our last link; redo it.
+		if (marked(links(n)[0].load(std::memory_order_acquire))) locate(key, preds, succs);
+		release_ref(n);
+	}
+};
+
+}// namespace sjtu
+
+#endif
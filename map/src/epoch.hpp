@@ -0,0 +1,198 @@
+#ifndef SJTU_EPOCH_HPP
+#define SJTU_EPOCH_HPP
+
+#include "exceptions.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace sjtu {
+
+/**
+ * Epoch-based reclamation shared by the concurrent containers.
+ *
+ * A thread pins the current epoch (epoch_guard) while it may hold pointers
+ * into a shared structure. Writers unlink an object and retire() it; the
+ * object is destroyed once the global epoch has advanced twice past the
+ * epoch it was retired in, which is only possible after every thread that
+ * could still see it has unpinned.
+ *
+ * Pinning is a thread-local counter bump plus one store, so readers never
+ * wait on writers or on each other.
+ */
+class epoch_domain {
+public:
+	static constexpr size_t max_threads = 256;
+	static constexpr size_t reclaim_threshold = 64;
+
+private:
+	struct retired {
+		void *ptr;
+		void (*deleter)(void *);
+		uint64_t epoch;
+		retired *next;
+	};
+	struct alignas(64) slot {
+		// 0 when the owning thread is outside any critical section,
+		// otherwise the epoch it observed when it pinned.
+		std::atomic<uint64_t> state{0};
+		std::atomic<bool> used{false};
+		size_t nest = 0;
+		retired *list = nullptr;
+		size_t count = 0;
+	};
+	struct thread_record {
+		slot *s = nullptr;
+		~thread_record() {
+			if (s) epoch_domain::global().release(s);
+		}
+	};
+
+	epoch_domain() = default;
+
+public:
+	epoch_domain(const epoch_domain &) = delete;
+	epoch_domain &operator=(const epoch_domain &) = delete;
+	~epoch_domain() {
+		for (slot &s : _slots) free_list(s.list);
+		free_list(_orphans);
+	}
+
+	static epoch_domain &global() {
+		static epoch_domain domain;
+		return domain;
+	}
+
+	void pin() {
+		slot &s = local();
+		if (s.nest++) return;
+		s.state.store(_epoch.load(std::memory_order_seq_cst), std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	}
+	void unpin() {
+		slot &s = local();
+		if (--s.nest) return;
+		s.state.store(0, std::memory_order_release);
+	}
+
+	/**
+	 * hand ptr over to the domain; deleter(ptr) runs once no pinned thread
+	 * can still reach it. ptr must already be unreachable for new readers.
+	 */
+	void retire(void *ptr, void (*deleter)(void *)) {
+		slot &s = local();
+		s.list = new retired{ptr, deleter, _epoch.load(std::memory_order_seq_cst), s.list};
+		if (++s.count >= reclaim_threshold) collect();
+	}
+	template<class U>
+	void retire(U *ptr) {
+		retire(ptr, [](void *p) { delete static_cast<U *>(p); });
+	}
+
+	/**
+	 * try to advance the epoch and free whatever the calling thread (and
+	 * exited threads) retired long enough ago.
+	 */
+	void collect() {
+		uint64_t e = try_advance();
+		slot &s = local();
+		s.count -= free_expired(s.list, e);
+		if (_orphans_hint.load(std::memory_order_relaxed)) {
+			std::lock_guard<std::mutex> lock(_orphan_mutex);
+			free_expired(_orphans, e);
+			_orphans_hint.store(_orphans != nullptr, std::memory_order_relaxed);
+		}
+	}
+
+	[[nodiscard]] uint64_t epoch() const { return _epoch.load(std::memory_order_acquire); }
+
+private:
+	std::atomic<uint64_t> _epoch{1};
+	slot _slots[max_threads];
+	std::mutex _orphan_mutex;
+	retired *_orphans = nullptr;
+	std::atomic<bool> _orphans_hint{false};
+
+private:
+	slot &local() {
+		thread_local thread_record rec;
+		if (!rec.s) rec.s = acquire();
+		return *rec.s;
+	}
+	slot *acquire() {
+		for (slot &s : _slots) {
+			bool expected = false;
+			if (!s.used.load(std::memory_order_relaxed) && s.used.compare_exchange_strong(expected, true))
+				return &s;
+		}
+		SJTU_THROW(runtime_error);
+	}
+	void release(slot *s) {
+		if (s->list) {
+			std::lock_guard<std::mutex> lock(_orphan_mutex);
+			retired *tail = s->list;
+			while (tail->next) tail = tail->next;
+			tail->next = _orphans;
+			_orphans = s->list;
+			_orphans_hint.store(true, std::memory_order_relaxed);
+		}
+		s->list = nullptr;
+		s->count = 0;
+		s->nest = 0;
+		s->state.store(0, std::memory_order_relaxed);
+		s->used.store(false, std::memory_order_release);
+	}
+
+	// the epoch can move on only when every pinned thread has seen the current one.
+	uint64_t try_advance() {
+		uint64_t e = _epoch.load(std::memory_order_seq_cst);
+		for (slot &s : _slots) {
+			if (!s.used.load(std::memory_order_acquire)) continue;
+			uint64_t st = s.state.load(std::memory_order_seq_cst);
+			if (st && st != e) return e;
+		}
+		_epoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+		return _epoch.load(std::memory_order_seq_cst);
+	}
+	static size_t free_expired(retired *&list, uint64_t e) {
+		size_t freed = 0;
+		for (retired **p = &list; *p;) {
+			retired *r = *p;
+			if (r->epoch + 2 <= e) {
+				*p = r->next;
+				r->deleter(r->ptr);
+				delete r;
+				++freed;
+			}
+			else
+				p = &r->next;
+		}
+		return freed;
+	}
+	static void free_list(retired *&list) {
+		while (list) {
+			retired *r = list;
+			list = r->next;
+			r->deleter(r->ptr);
+			delete r;
+		}
+	}
+};
+
+/**
+ * RAII pin of the global epoch domain. Guards nest, so copying one inside
+ * a critical section is cheap and keeps the section open until the last
+ * copy dies. A guard must stay on the thread that created it.
+ */
+class epoch_guard {
+public:
+	epoch_guard() { epoch_domain::global().pin(); }
+	epoch_guard(const epoch_guard &) { epoch_domain::global().pin(); }
+	epoch_guard &operator=(const epoch_guard &) = default;
+	~epoch_guard() { epoch_domain::global().unpin(); }
+};
+
+}// namespace sjtu
+
+#endif
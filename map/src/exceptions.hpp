@@ -2,38 +2,73 @@
 #define SJTU_EXCEPTIONS_HPP
 
 #include <cstddef>
-#include <cstring>
-#include <string>
+#include <cstdio>
+#include <cstdlib>
 
 namespace sjtu {
 
+/**
+ * the exceptions thrown by the containers. Each holds a pointer to a
+ * static message, so constructing, copying and throwing one never
+ * allocates.
+ */
 class exception {
 protected:
-	const std::string variant = "";
-	std::string detail = "";
+	const char *message = "exception";
+
 public:
-	exception() {}
-	exception(const exception &ec) : variant(ec.variant), detail(ec.detail) {}
-	virtual std::string what() {
-		return variant + " " + detail;
+	exception() noexcept = default;
+	explicit exception(const char *message) noexcept : message(message) {}
+	exception(const exception &ec) noexcept = default;
+	exception &operator=(const exception &ec) noexcept = default;
+	virtual ~exception() = default;
+	virtual const char *what() const noexcept {
+		return message;
 	}
 };
 
 class index_out_of_bound : public exception {
-	/* __________________________ */
+public:
+	index_out_of_bound() noexcept : exception("index_out_of_bound") {}
 };
 
 class runtime_error : public exception {
-	/* __________________________ */
+public:
+	runtime_error() noexcept : exception("runtime_error") {}
 };
 
 class invalid_iterator : public exception {
-	/* __________________________ */
+public:
+	invalid_iterator() noexcept : exception("invalid_iterator") {}
 };
 
 class container_is_empty : public exception {
-	/* __________________________ */
+public:
+	container_is_empty() noexcept : exception("container_is_empty") {}
 };
+
+/**
+ * the containers throw, try and rethrow through these macros. With
+ * SJTU_NO_EXCEPTIONS defined they compile under -fno-exceptions: a failed
+ * check prints what() and aborts, like an assertion, and the rollback
+ * code in catch blocks is compiled out.
+ */
+#ifdef SJTU_NO_EXCEPTIONS
+[[noreturn]] inline void fail(const exception &e) noexcept {
+	std::fprintf(stderr, "sjtu: %s\n", e.what());
+	std::abort();
+}
+#define SJTU_THROW(type) ::sjtu::fail(type{})
+#define SJTU_TRY if (true)
+#define SJTU_CATCH_ALL else
+#define SJTU_RETHROW ((void) 0)
+#else
+#define SJTU_THROW(type) throw type{}
+#define SJTU_TRY try
+#define SJTU_CATCH_ALL catch (...)
+#define SJTU_RETHROW throw
+#endif
+
 }
 
 #endif
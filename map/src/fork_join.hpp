@@ -0,0 +1,63 @@
+#ifndef SJTU_FORK_JOIN_HPP
+#define SJTU_FORK_JOIN_HPP
+
+#include "exceptions.hpp"
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <thread>
+
+namespace sjtu {
+
+/**
+ * executor for the divide-and-conquer set operations of sjtu::map.
+ *
+ * A step whose work estimate reaches grain runs its first half on a new
+ * thread while the caller runs the second, as long as fewer than
+ * max_threads helpers are alive; everything else runs inline. The caller
+ * always joins its own helper, so no step ever waits on unrelated work.
+ */
+class fork_join {
+public:
+	explicit fork_join(size_t max_threads = std::thread::hardware_concurrency(), size_t grain = 1 << 14)
+		: _limit(max_threads > 1 ? max_threads - 1 : 0), _grain(grain) {}
+	fork_join(const fork_join &) = delete;
+	fork_join &operator=(const fork_join &) = delete;
+
+	template<class F, class G>
+	void operator()(size_t work, F &&f, G &&g) {
+		if (work < _grain || !reserve()) {
+			f();
+			g();
+			return;
+		}
+		std::future<void> helper;
+		SJTU_TRY {
+			helper = std::async(std::launch::async, [&] { f(); });
+		} SJTU_CATCH_ALL {
+			_active.fetch_sub(1, std::memory_order_relaxed);
+			f();
+			g();
+			return;
+		}
+		g();
+		helper.get();
+		_active.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+private:
+	bool reserve() {
+		size_t cur = _active.load(std::memory_order_relaxed);
+		while (cur < _limit)
+			if (_active.compare_exchange_weak(cur, cur + 1, std::memory_order_relaxed)) return true;
+		return false;
+	}
+
+private:
+	std::atomic<size_t> _active{0};
+	size_t _limit, _grain;
+};
+
+}// namespace sjtu
+
+#endif
@@ -3,15 +3,39 @@
 #define SJTU_MAP_H
 
 #include "exceptions.hpp"
+#include "stats.hpp"
 #include "utility.hpp"
 #include <cstddef>
 #include <functional>
+#include <type_traits>
 
 namespace sjtu {
 
 enum NodeColor { red,
 				 black };
 
+#ifdef SJTU_STATS
+// process-wide totals of map::stats().
+namespace counters {
+inline stat_counter map_rotations{"map.rotations"};
+inline stat_counter map_recolours{"map.recolours"};
+inline stat_counter map_height{"map.height", stat_counter::max};
+}// namespace counters
+#endif
+
+/**
+ * runs both halves of a divide-and-conquer step in the calling thread.
+ * work is an estimate of the elements below this step; see fork_join.hpp
+ * for an executor that uses it.
+ */
+struct sequential_fork {
+	template<class F, class G>
+	void operator()(size_t, F &&f, G &&g) const {
+		f();
+		g();
+	}
+};
+
 template<class Key,
 		 class T,
 		 class Compare = std::less<Key>,
@@ -85,17 +109,8 @@ private:
 		}
 		iterator_common &operator++() {
 			Node *&p = this->_ptr;
-			if (!p) throw sjtu::invalid_iterator{};
-			if (p->son[1]) {
-				p = p->son[1];
-				while (p->son[0]) p = p->son[0];
-				return *this;
-			}
-			while (p->fa && p->who() == 1)
-				p = p->fa;
-			if (p->fa) p = p->fa;
-			else
-				p = nullptr;
+			if (!p) SJTU_THROW(invalid_iterator);
+			p = map::next_node(p);
 			return *this;
 		}
 		iterator_common operator--(int) {
@@ -106,7 +121,7 @@ private:
 		iterator_common &operator--() {
 			Node *&p = this->_ptr;
 			if (!p) {
-				if (this->_map->empty()) throw invalid_iterator{};
+				if (this->_map->empty()) SJTU_THROW(invalid_iterator);
 				p = this->_map->back_ptr();
 				return *this;
 			}
@@ -118,7 +133,7 @@ private:
 			while (p->fa && p->who() == 0) p = p->fa;
 			if (p->fa) p = p->fa;
 			else
-				throw invalid_iterator{};
+				SJTU_THROW(invalid_iterator);
 			return *this;
 		}
 		reference operator*() const { return this->_ptr->data; }
@@ -162,16 +177,9 @@ public:
 
 	T &at(const Key &key) { return const_cast<T &>(const_cast<const map *>(this)->at(key)); }
 	const T &at(const Key &key) const {
-		Node *p = _rt;
-		while (p) {
-			if (opt(key, p->data.first))
-				p = p->son[0];
-			else if (opt(p->data.first, key))
-				p = p->son[1];
-			else
-				return p->data.second;
-		}
-		throw index_out_of_bound{};
+		Node *p = locate(key).node;
+		if (!p) SJTU_THROW(index_out_of_bound);
+		return p->data.second;
 	}
 	T &operator[](const Key &key) { return insert({key, T{}}).first->second; }
 	const T &operator[](const Key &key) const { return at(key); }
@@ -191,27 +199,13 @@ public:
 		_size = 0;
 	}
 
-	pair<iterator, bool> insert(const value_type &value) {
-		Node **ptr = &_rt, *last = nullptr;
-		while (*ptr) {
-			Node *p = last = *ptr;
-			if (opt(p->data.first, value.first))
-				ptr = &p->son[1];
-			else if (opt(value.first, p->data.first))
-				ptr = &p->son[0];
-			else
-				return {{p, this}, false};
-		}
-		Node *ret = *ptr = _alloc.allocate(1);
-		new (ret) Node{last, value};
-		++_size;
-		update_insert(ret);
-		return {{ret, this}, true};
-	}
+	pair<iterator, bool> insert(const value_type &value) { return insert_value(value); }
+	// the value is moved into the new node; left alone if the key is present.
+	pair<iterator, bool> insert(value_type &&value) { return insert_value(std::move(value)); }
 
 	void erase(iterator const &pos) {
 		if (pos._ptr == nullptr || pos._map != this)
-			throw invalid_iterator{};
+			SJTU_THROW(invalid_iterator);
 		Node *p = pos._ptr;
 		// after swap, p have at most 1 child.
 		if (p->son[0] && p->son[1]) {
@@ -228,35 +222,346 @@ public:
 
 	size_t count(const Key &key) const { return find(key) != end(); }
 	iterator find(const Key &key) {
-		Node *p = _rt;
-		while (p) {
-			if (opt(key, p->data.first))
-				p = p->son[0];
-			else if (opt(p->data.first, key))
-				p = p->son[1];
-			else
-				return {p, this};
-		}
-		return end();
+		Node *p = locate(key).node;
+		return p ? iterator{p, this} : end();
 	}
 	const_iterator find(const Key &key) const {
 		return const_cast<map *>(this)->find(key);
 	}
 
+	/**
+	 * look up every key in [first, last) and write find(key) (or, for
+	 * contains_batch, whether it is there) to out, in order.
+	 * The descents are interleaved so their cache misses overlap; the
+	 * _sorted versions expect keys ascending by Compare and walk the tree
+	 * once per chunk of keys, visiting shared path prefixes only once.
+	 */
+	template<class ForwardIt, class OutputIt>
+	OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out) {
+		batch_locate(first, last, [&](Node *p) { *out++ = iterator{p, this}; });
+		return out;
+	}
+	template<class ForwardIt, class OutputIt>
+	OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out) const {
+		batch_locate(first, last, [&](Node *p) { *out++ = const_iterator{p, this}; });
+		return out;
+	}
+	template<class ForwardIt, class OutputIt>
+	OutputIt contains_batch(ForwardIt first, ForwardIt last, OutputIt out) const {
+		batch_locate(first, last, [&](Node *p) { *out++ = p != nullptr; });
+		return out;
+	}
+	template<class ForwardIt, class OutputIt>
+	OutputIt find_batch_sorted(ForwardIt first, ForwardIt last, OutputIt out) {
+		batch_locate_sorted(first, last, [&](Node *p) { *out++ = iterator{p, this}; });
+		return out;
+	}
+	template<class ForwardIt, class OutputIt>
+	OutputIt find_batch_sorted(ForwardIt first, ForwardIt last, OutputIt out) const {
+		batch_locate_sorted(first, last, [&](Node *p) { *out++ = const_iterator{p, this}; });
+		return out;
+	}
+	template<class ForwardIt, class OutputIt>
+	OutputIt contains_batch_sorted(ForwardIt first, ForwardIt last, OutputIt out) const {
+		batch_locate_sorted(first, last, [&](Node *p) { *out++ = p != nullptr; });
+		return out;
+	}
+
+	/**
+	 * set operations by join and split, O(m log(n/m + 1)) for sizes m <= n.
+	 * The two halves of every step are independent and handed to fork,
+	 * which may run them on different threads. They only relink nodes: the
+	 * ones dropped are collected and freed on the calling thread after the
+	 * last join, so the allocator need not be thread-safe.
+	 * Compare must not throw, and the allocators must be interchangeable.
+	 */
+	// add the elements of other whose keys are missing; on equal keys *this wins, as in insert().
+	template<class Fork = sequential_fork>
+	void union_with(map &&other, Fork &&fork = Fork{}) {
+		if (this == &other) return;
+		size_t work = _size + other._size;
+		garbage dup;
+		tree t = unite(whole(), other.whole(), work, fork, dup);
+		other._rt = nullptr;
+		other._size = 0;
+		_size = work - release(dup);
+		set_root(t);
+	}
+	// copies other first, which adds O(|other|) allocations to the bound above.
+	template<class Fork = sequential_fork>
+	void union_with(const map &other, Fork &&fork = Fork{}) {
+		if (this != &other) union_with(map(other), fork);
+	}
+	// keep only the keys also present in other.
+	template<class Fork = sequential_fork>
+	void intersect_with(const map &other, Fork &&fork = Fork{}) {
+		if (this == &other) return;
+		garbage removed;
+		tree t = intersect(whole(), other._rt, _size + other._size, fork, removed);
+		_size -= release(removed);
+		set_root(t);
+	}
+	// drop the keys present in other.
+	template<class Fork = sequential_fork>
+	void difference_with(const map &other, Fork &&fork = Fork{}) {
+		if (this == &other) return clear();
+		garbage removed;
+		tree t = subtract(whole(), other._rt, _size + other._size, fork, removed);
+		_size -= release(removed);
+		set_root(t);
+	}
+	/**
+	 * move the elements not less than key into the returned map.
+	 * O(log n) to cut the tree, plus O(min(k, n - k)) to count the sides.
+	 */
+	map split_at(const Key &key) {
+		split_result s = split(whole(), key);
+		if (s.m) s.r = join({}, s.m, s.r);
+		map ret;
+		ret._alloc = _alloc;
+		size_t k = count_right(s.l.rt, s.r.rt, _size);
+		set_root(s.l);
+		ret.set_root(s.r);
+		ret._size = k;
+		_size -= k;
+		return ret;
+	}
+
+	/**
+	 * what the insert and erase fix-ups of this map did. The joins behind
+	 * split_at and the set operations only count in the process-wide
+	 * totals.
+	 */
+#ifdef SJTU_STATS
+	struct stats_type {
+		size_t rotations = 0;
+		size_t recolours = 0;
+		size_t height = 0;// the deepest level a node was inserted at, the root being 1
+	};
+	const stats_type &stats() const { return _stats; }
+#else
+	struct stats_type {};
+#endif
+
 private:
 	Node *_rt = nullptr;
 	size_t _size = 0;
 	[[no_unique_address]] Compare opt;
 	[[no_unique_address]] Alloc<Node> _alloc;
+	[[no_unique_address]] stats_type _stats;
 
 private:
-	void rotate(Node *p) {
+	// where a key is, or where it would be inserted: node is nullptr then, and the new node goes to fa->son[side].
+	struct position {
+		Node *node;
+		Node *fa;
+		int side;
+	};
+	static constexpr int batch_width = 16;
+	static constexpr int sorted_chunk = 256;
+	// arithmetic, enum and pointer keys under std::less / std::greater: comparing them is cheaper than a mispredicted branch.
+	static constexpr bool builtin_order =
+			std::is_scalar<Key>::value && !std::is_member_pointer<Key>::value && !std::is_null_pointer<Key>::value &&
+			(std::is_same<Compare, std::less<Key>>::value || std::is_same<Compare, std::less<>>::value ||
+			 std::is_same<Compare, std::greater<Key>>::value || std::is_same<Compare, std::greater<>>::value);
+	static constexpr bool descending =
+			std::is_same<Compare, std::greater<Key>>::value || std::is_same<Compare, std::greater<>>::value;
+
+	// SJTU_MAP_NO_PREFETCH turns the prefetches off, to measure what they bring.
+	static void prefetch(const void *p) {
+#if defined(__GNUC__) && !defined(SJTU_MAP_NO_PREFETCH)
+		__builtin_prefetch(p);
+#endif
+	}
+
+	// both inserts; V is value_type or a const reference to one.
+	template<class V>
+	pair<iterator, bool> insert_value(V &&value) {
+		position pos = locate(value.first);
+		if (pos.node) return {{pos.node, this}, false};
+		Node *ret = _alloc.allocate(1);
+		SJTU_TRY {
+			new (ret) Node{pos.fa, std::forward<V>(value)};
+		} SJTU_CATCH_ALL {
+			_alloc.deallocate(ret, 1);
+			SJTU_RETHROW;
+		}
+		(pos.fa ? pos.fa->son[pos.side] : _rt) = ret;
+		++_size;
+		update_insert(ret);
+		return {{ret, this}, true};
+	}
+
+	/**
+	 * the descent shared by at, find and insert.
+	 * For built-in keys every level does one comparison and picks the child
+	 * as son[key > node] without a branch. It prefetches both children of
+	 * the node before comparing, so the next node's load starts alongside
+	 * the compare and the select instead of after them: one level of
+	 * lookahead, the most that helps here; map-bench-descent_no_prefetch
+	 * measures it. Other keys keep the two Compare calls per level.
+	 */
+	position locate(const Key &key) const {
+		Node *p = _rt, *fa = nullptr;
+		int side = 0;
+		while (p) {
+			if constexpr (builtin_order) {
+				prefetch(p->son[0]);
+				prefetch(p->son[1]);
+			}
+			int d = probe(key, p);
+			if (d == 2) return {p, fa, side};
+			side = d;
+			fa = p;
+			p = p->son[side];
+		}
+		return {nullptr, fa, side};
+	}
+	// 0 or 1: key belongs under p->son[0] or p->son[1]; 2: p holds key.
+	int probe(const Key &key, const Node *p) const {
+		if constexpr (builtin_order) {
+			// both tests read the flags of one cmp; a <=> result gets branched on instead.
+			const Key k = p->data.first;
+			return k == key ? 2 : descending ? key < k : k < key;
+		}
+		else
+			return opt(key, p->data.first) ? 0 : opt(p->data.first, key) ? 1 : 2;
+	}
+
+	/**
+	 * group prefetching: descend up to batch_width keys in lock-step, one
+	 * level per round, prefetching every lane's next node before touching
+	 * any of them, so the cache misses of a round overlap.
+	 * emit(Node *) is called for every key in input order.
+	 */
+	template<class ForwardIt, class Emit>
+	void batch_locate(ForwardIt first, ForwardIt last, Emit &&emit) const {
+		const Key *keys[batch_width];
+		Node *cur[batch_width], *hit[batch_width];
+		while (first != last) {
+			int n = 0;
+			for (; n < batch_width && first != last; ++n, ++first) {
+				keys[n] = &*first;
+				cur[n] = _rt;
+				hit[n] = nullptr;
+			}
+			for (bool active = _rt != nullptr; active;) {
+				active = false;
+				for (int i = 0; i < n; ++i) {
+					Node *p = cur[i];
+					if (!p) continue;
+					int d = probe(*keys[i], p);
+					if (d == 2) {
+						hit[i] = p;
+						cur[i] = nullptr;
+						continue;
+					}
+					cur[i] = p = p->son[d];
+					if (p) {
+						prefetch(p);
+						active = true;
+					}
+				}
+			}
+			for (int i = 0; i < n; ++i) emit(hit[i]);
+		}
+	}
+	/**
+	 * keys sorted by Compare: walk the tree breadth first, carrying to each
+	 * node the slice of keys that belongs under it, so a node shared by
+	 * several search paths is visited once per chunk. Each level's nodes are
+	 * prefetched before the previous level is finished with.
+	 */
+	template<class ForwardIt, class Emit>
+	void batch_locate_sorted(ForwardIt first, ForwardIt last, Emit &&emit) const {
+		struct slice {
+			Node *p;
+			int lo, hi;
+		};
+		const Key *keys[sorted_chunk];
+		Node *hit[sorted_chunk];
+		slice cur[sorted_chunk], next[sorted_chunk];
+		while (first != last) {
+			int n = 0;
+			for (; n < sorted_chunk && first != last; ++n, ++first) {
+				keys[n] = &*first;
+				hit[n] = nullptr;
+			}
+			int m = 0;
+			if (_rt) cur[m++] = {_rt, 0, n};
+			while (m) {
+				int k = 0;
+				for (int i = 0; i < m; ++i) {
+					auto [p, lo, hi] = cur[i];
+					const Key &key = p->data.first;
+					int eq = lo, gt;
+					while (eq < hi && opt(*keys[eq], key)) ++eq;
+					for (gt = eq; gt < hi && !opt(key, *keys[gt]); ++gt) hit[gt] = p;
+					if (lo < eq && p->son[0]) {
+						prefetch(p->son[0]);
+						next[k++] = {p->son[0], lo, eq};
+					}
+					if (gt < hi && p->son[1]) {
+						prefetch(p->son[1]);
+						next[k++] = {p->son[1], gt, hi};
+					}
+				}
+				for (int i = 0; i < k; ++i) cur[i] = next[i];
+				m = k;
+			}
+			for (int i = 0; i < n; ++i) emit(hit[i]);
+		}
+	}
+
+	// a detached subtree with its black height (black nodes on a path down, root included).
+	struct tree {
+		Node *rt = nullptr;
+		int bh = 0;
+	};
+	struct split_result {
+		tree l;
+		Node *m;
+		tree r;
+	};
+	// subtrees dropped by a set operation, chained through the fa of their roots.
+	struct garbage {
+		Node *head = nullptr, *tail = nullptr;
+		void add(Node *p) {
+			p->fa = nullptr;
+			(tail ? tail->fa : head) = p;
+			tail = p;
+		}
+		void add_node(Node *p) {
+			p->son[0] = p->son[1] = nullptr;
+			add(p);
+		}
+		void append(const garbage &g) {
+			if (!g.head) return;
+			(tail ? tail->fa : head) = g.head;
+			tail = g.tail;
+		}
+	};
+
+private:
+	void rotate(Node *p) { rotate(p, _rt, _stats); }
+	static void rotate(Node *p, Node *&rt, stats_type &st) {
+		count_rotation(st);
 		int m = p->who();
 		Node *fa = p->fa, *pa = p->fa->fa;
 		link(p->son[m ^ 1], fa, m);
 		link(p, pa, pa ? fa->who() : 0);
 		link(fa, p, m ^ 1);
-		if (!pa) _rt = p;
+		if (!pa) rt = p;
+	}
+	static Node *next_node(Node *p) {
+		if (p->son[1]) {
+			p = p->son[1];
+			while (p->son[0]) p = p->son[0];
+			return p;
+		}
+		while (p->fa && p->who() == 1)
+			p = p->fa;
+		return p->fa;
 	}
 	Node *begin_ptr() const {
 		if (!_rt) return end_ptr();
@@ -305,36 +610,47 @@ private:
 		// no need to set s to black, if p is already red.
 		// no need to adjust the tree.
 		if (p->color == red) return;
-		if (!s || s->color == black)
+		if (!s || s->color == black) {
 			update_erase(p->fa, k);
-		else
+		} else {
 			s->color = black;
+			count_recolours(_stats, 1);
+		}
 	}
 	void update_insert(Node *p) {
+		count_height(p);
+		update_insert(p, _rt, _stats);
+	}
+	// @return whether the black height of the whole tree grew
+	static bool update_insert(Node *p, Node *&rt, stats_type &st) {
 		Node *uncle = nullptr;
 		while (p->fa && p->fa->color == red && (uncle = p->fa->brother()) && uncle->color == red) {
 			// p has red father imply p has grandpa
 			p->fa->fa->color = red;
 			p->fa->color = black;
 			uncle->color = black;
+			count_recolours(st, 3);
 			p = p->fa->fa;
 		}
 		Node *fa = p->fa;
 		if (!fa) {
 			p->color = black;
-			_rt = p;
-			return;
+			count_recolours(st, 1);
+			rt = p;
+			return true;
 		}
-		if (fa->color == black) return;
+		if (fa->color == black) return false;
 		Node *pa = fa->fa;
 		int m = p->who(), n = fa->who();
 		if (m != n) {
-			rotate(p);
+			rotate(p, rt, st);
 			fa = p;
 		}
-		rotate(fa);
+		rotate(fa, rt, st);
 		fa->color = black;
 		pa->color = red;
+		count_recolours(st, 2);
+		return false;
 	}
 	void update_erase(Node *p, int k) {
 		while (true) {
@@ -349,6 +665,7 @@ private:
 				rotate(s);
 				s->color = black;
 				p->color = red;
+				count_recolours(_stats, 2);
 				s = p->son[k ^ 1];
 			}
 			// case 5: leading to case 6
@@ -356,6 +673,7 @@ private:
 				rotate(sk);
 				sk->color = black;
 				s->color = red;
+				count_recolours(_stats, 2);
 				s = sk;
 				// not break, go in case 6
 			}
@@ -365,6 +683,7 @@ private:
 				s->son[k ^ 1]->color = black;
 				s->color = p->color;
 				p->color = black;
+				count_recolours(_stats, 3);
 				break;
 			}
 			// now the children of s are black
@@ -372,10 +691,12 @@ private:
 			if (p->color == red) {
 				p->color = black;
 				s->color = red;
+				count_recolours(_stats, 2);
 				break;
 			}
 			// case 3, loop again
 			s->color = red;
+			count_recolours(_stats, 1);
 			if (!p->fa) {
 				_rt = p;
 				break;
@@ -384,6 +705,202 @@ private:
 			p = p->fa;
 		}
 	}
+
+	// instrumentation, see stats.hpp; these do nothing without SJTU_STATS.
+	static void count_rotation([[maybe_unused]] stats_type &st) {
+#ifdef SJTU_STATS
+		++st.rotations;
+		counters::map_rotations.add(1);
+#endif
+	}
+	static void count_recolours([[maybe_unused]] stats_type &st, [[maybe_unused]] size_t n) {
+#ifdef SJTU_STATS
+		st.recolours += n;
+		counters::map_recolours.add(n);
+#endif
+	}
+	void count_height([[maybe_unused]] Node *p) {
+#ifdef SJTU_STATS
+		size_t h = 0;
+		for (; p; p = p->fa) ++h;
+		if (h > _stats.height) _stats.height = h;
+		counters::map_height.add(h);
+#endif
+	}
+
+	tree whole() const { return {_rt, black_height(_rt)}; }
+	void set_root(tree t) {
+		_rt = t.rt;
+		if (_rt) {
+			_rt->fa = nullptr;
+			_rt->color = black;
+		}
+	}
+	static int black_height(Node *p) {
+		int h = 0;
+		for (; p; p = p->son[0]) h += p->color == black;
+		return h;
+	}
+	static tree child(Node *p, int i, int bh) {
+		Node *c = p->son[i];
+		if (c) c->fa = nullptr;
+		return {c, bh - (p->color == black)};
+	}
+	static void blacken(tree &t) {
+		if (t.rt && t.rt->color == red) {
+			t.rt->color = black;
+			++t.bh;
+		}
+	}
+	void destroy_node(Node *p) {
+		p->~Node();
+		_alloc.deallocate(p, 1);
+	}
+	size_t release_count(Node *p) {
+		if (!p) return 0;
+		size_t n = release_count(p->son[0]) + release_count(p->son[1]) + 1;
+		destroy_node(p);
+		return n;
+	}
+	// free what a set operation dropped; returns the number of nodes.
+	size_t release(const garbage &g) {
+		size_t n = 0;
+		for (Node *p = g.head; p;) {
+			Node *next = p->fa;
+			n += release_count(p);
+			p = next;
+		}
+		return n;
+	}
+	// size of the tree at r, walking both trees in step so only the smaller one is traversed.
+	static size_t count_right(Node *l, Node *r, size_t total) {
+		if (l) l = leftmost(l);
+		if (r) r = leftmost(r);
+		size_t k = 0;
+		for (; l && r; ++k) {
+			l = next_node(l);
+			r = next_node(r);
+		}
+		return r ? total - k : k;
+	}
+	static Node *leftmost(Node *p) {
+		while (p->son[0]) p = p->son[0];
+		return p;
+	}
+
+	/**
+	 * all keys of l < k < all keys of r.
+	 * Walk down the spine of the taller tree to a black node of the other
+	 * tree's black height and hang k there as a red node; the rest is the
+	 * usual insertion fix-up. O(|bh(l) - bh(r)| + 1) amortised.
+	 */
+	static tree join(tree l, Node *k, tree r) {
+		blacken(l);
+		blacken(r);
+		k->fa = k->son[0] = k->son[1] = nullptr;
+		k->color = red;
+		int side = l.bh < r.bh;// spine to walk: 0 means the right spine of l
+		tree &big = side ? r : l;
+		int target = side ? l.bh : r.bh, h = big.bh;
+		Node *fa = nullptr, *x = big.rt;
+		while (x && (x->color == red || h > target)) {
+			h -= x->color == black;
+			fa = x;
+			x = x->son[side ^ 1];
+		}
+		link(side ? l.rt : x, k, 0);
+		link(side ? x : r.rt, k, 1);
+		Node *rt = fa ? big.rt : k;
+		if (fa) link(k, fa, side ^ 1);
+		stats_type st;
+		bool grew = update_insert(k, rt, st);
+		return {rt, big.bh + grew};
+	}
+	static tree join2(tree l, tree r) {
+		if (!l.rt) return r;
+		Node *k = nullptr;
+		tree rest = split_last(l, k);
+		return join(rest, k, r);
+	}
+	static tree split_last(tree t, Node *&last) {
+		Node *p = t.rt;
+		tree a = child(p, 0, t.bh), b = child(p, 1, t.bh);
+		if (!b.rt) {
+			last = p;
+			return a;
+		}
+		tree rest = split_last(b, last);
+		return join(a, p, rest);
+	}
+	// cut t into keys < key, the node equal to key (if any), keys > key.
+	split_result split(tree t, const Key &key) const {
+		if (!t.rt) return {{}, nullptr, {}};
+		Node *p = t.rt;
+		tree a = child(p, 0, t.bh), b = child(p, 1, t.bh);
+		if (opt(key, p->data.first)) {
+			split_result s = split(a, key);
+			s.r = join(s.r, p, b);
+			return s;
+		}
+		if (opt(p->data.first, key)) {
+			split_result s = split(b, key);
+			s.l = join(a, p, s.l);
+			return s;
+		}
+		return {a, p, b};
+	}
+
+	template<class Fork>
+	tree unite(tree a, tree b, size_t work, Fork &fork, garbage &dup) const {
+		if (!a.rt) return b;
+		if (!b.rt) return a;
+		Node *p = a.rt;
+		split_result s = split(b, p->data.first);
+		tree al = child(p, 0, a.bh), ar = child(p, 1, a.bh), l, r;
+		garbage dl, dr;
+		fork(
+				work,
+				[&] { l = unite(al, s.l, work / 2, fork, dl); },
+				[&] { r = unite(ar, s.r, work / 2, fork, dr); });
+		if (s.m) dup.add_node(s.m);
+		dup.append(dl);
+		dup.append(dr);
+		return join(l, p, r);
+	}
+	template<class Fork>
+	tree intersect(tree a, Node *b, size_t work, Fork &fork, garbage &removed) const {
+		if (!a.rt) return a;
+		if (!b) {
+			removed.add(a.rt);
+			return {};
+		}
+		split_result s = split(a, b->data.first);
+		tree l, r;
+		garbage rl, rr;
+		fork(
+				work,
+				[&] { l = intersect(s.l, b->son[0], work / 2, fork, rl); },
+				[&] { r = intersect(s.r, b->son[1], work / 2, fork, rr); });
+		removed.append(rl);
+		removed.append(rr);
+		if (s.m) return join(l, s.m, r);
+		return join2(l, r);
+	}
+	template<class Fork>
+	tree subtract(tree a, Node *b, size_t work, Fork &fork, garbage &removed) const {
+		if (!a.rt || !b) return a;
+		split_result s = split(a, b->data.first);
+		tree l, r;
+		garbage rl, rr;
+		fork(
+				work,
+				[&] { l = subtract(s.l, b->son[0], work / 2, fork, rl); },
+				[&] { r = subtract(s.r, b->son[1], work / 2, fork, rr); });
+		removed.append(rl);
+		removed.append(rr);
+		if (s.m) removed.add_node(s.m);
+		return join2(l, r);
+	}
 };
 
 template<typename T>
@@ -0,0 +1,130 @@
+#ifndef SJTU_RCU_MAP_HPP
+#define SJTU_RCU_MAP_HPP
+
+#include "epoch.hpp"
+#include "exceptions.hpp"
+#include "map.hpp"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+
+namespace sjtu {
+
+/**
+ * a map for many readers and few writers.
+ *
+ * Readers work on an immutable sjtu::map published through an atomic
+ * pointer and never take a lock: a lookup pins the epoch, loads the
+ * current version and walks it. Writers are serialised by a mutex; each
+ * write copies the current version, modifies the copy and publishes it,
+ * and the old version is retired to the epoch domain.
+ *
+ * A write therefore costs O(n). Use update() to apply a batch of changes
+ * with one copy. (The tree keeps parent pointers for its iterators, so a
+ * path-copying version could not share subtrees.)
+ */
+template<class Key,
+		 class T,
+		 class Compare = std::less<Key>,
+		 template<typename Type> class Alloc = std::allocator>
+class rcu_map {
+public:
+	using map_type = map<Key, T, Compare, Alloc>;
+	using value_type = typename map_type::value_type;
+	using const_iterator = typename map_type::const_iterator;
+
+	/**
+	 * a pinned, consistent read view. Iterators taken from it are valid
+	 * while it lives. It must not outlive the rcu_map or leave the thread
+	 * that created it.
+	 */
+	class snapshot {
+		friend class rcu_map;
+		explicit snapshot(const map_type *m) : _map(m) {}
+
+	public:
+		const T &at(const Key &key) const { return _map->at(key); }
+		const_iterator find(const Key &key) const { return _map->find(key); }
+		size_t count(const Key &key) const { return _map->count(key); }
+		const_iterator begin() const { return _map->cbegin(); }
+		const_iterator end() const { return _map->cend(); }
+		[[nodiscard]] bool empty() const { return _map->empty(); }
+		[[nodiscard]] size_t size() const { return _map->size(); }
+		const map_type &get() const { return *_map; }
+
+	private:
+		epoch_guard _guard;
+		const map_type *_map;
+	};
+
+public:
+	rcu_map() : _cur(new map_type) {}
+	explicit rcu_map(const map_type &init) : _cur(new map_type(init)) {}
+	rcu_map(const rcu_map &) = delete;
+	rcu_map &operator=(const rcu_map &) = delete;
+	~rcu_map() { delete _cur.load(std::memory_order_relaxed); }
+
+	// the guard is taken before the load, so the version cannot be reclaimed under us.
+	snapshot read() const {
+		epoch_guard g;
+		return snapshot{_cur.load(std::memory_order_acquire)};
+	}
+
+	T at(const Key &key) const { return read().at(key); }
+	size_t count(const Key &key) const { return read().count(key); }
+	[[nodiscard]] size_t size() const { return read().size(); }
+	[[nodiscard]] bool empty() const { return read().empty(); }
+
+	/**
+	 * run fn(map_type &) on a private copy of the current version and
+	 * publish the result. If fn throws, nothing is published.
+	 */
+	template<class Fn>
+	void update(Fn &&fn) {
+		std::lock_guard<std::mutex> lock(_write);
+		map_type *old = _cur.load(std::memory_order_relaxed);
+		map_type *next = new map_type(*old);
+		SJTU_TRY {
+			fn(*next);
+		} SJTU_CATCH_ALL {
+			delete next;
+			SJTU_RETHROW;
+		}
+		_cur.store(next, std::memory_order_release);
+		epoch_domain::global().retire(old);
+	}
+
+	bool insert(const value_type &value) {
+		bool inserted = false;
+		update([&](map_type &m) { inserted = m.insert(value).second; });
+		return inserted;
+	}
+	void assign(const Key &key, const T &value) {
+		update([&](map_type &m) { m[key] = value; });
+	}
+	size_t erase(const Key &key) {
+		size_t erased = 0;
+		update([&](map_type &m) {
+			auto it = m.find(key);
+			if (it != m.end()) {
+				m.erase(it);
+				erased = 1;
+			}
+		});
+		return erased;
+	}
+	void clear() {
+		std::lock_guard<std::mutex> lock(_write);
+		map_type *old = _cur.exchange(new map_type, std::memory_order_acq_rel);
+		epoch_domain::global().retire(old);
+	}
+
+private:
+	std::atomic<map_type *> _cur;
+	std::mutex _write;
+};
+
+}// namespace sjtu
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef SJTU_RECORDED_MAP_HPP
+#define SJTU_RECORDED_MAP_HPP
+
+#include "map.hpp"
+#include "trace.hpp"
+
+namespace sjtu {
+
+/**
+ * a map that appends every operation on it to a trace, see trace.hpp, to be
+ * replayed later against other implementations by stlite-replay. It has
+ * the interface of map, minus the batch and set operations; anything else
+ * is reached through base(), unrecorded. insert and operator[] are
+ * recorded as an insert and an assignment, erase and at under the key of
+ * their element, and count as a find.
+ */
+template<class Key,
+		 class T,
+		 class Compare = std::less<Key>,
+		 template<typename Type> class Alloc = std::allocator>
+class recorded_map {
+public:
+	using base_type = map<Key, T, Compare, Alloc>;
+	using value_type = typename base_type::value_type;
+	using iterator = typename base_type::iterator;
+	using const_iterator = typename base_type::const_iterator;
+
+	explicit recorded_map(const char *trace_path) : _trace(trace_path, trace_kind::map) {}
+	recorded_map(const recorded_map &) = delete;
+	recorded_map &operator=(const recorded_map &) = delete;
+
+	T &at(const Key &key) {
+		_trace.record(trace_find, trace_key(key));
+		return _map.at(key);
+	}
+	const T &at(const Key &key) const {
+		_trace.record(trace_find, trace_key(key));
+		return _map.at(key);
+	}
+	T &operator[](const Key &key) {
+		_trace.record(trace_assign, trace_key(key));
+		return _map[key];
+	}
+
+	iterator begin() { return _map.begin(); }
+	const_iterator begin() const { return _map.begin(); }
+	const_iterator cbegin() const { return _map.cbegin(); }
+	iterator end() { return _map.end(); }
+	const_iterator end() const { return _map.end(); }
+	const_iterator cend() const { return _map.cend(); }
+
+	[[nodiscard]] bool empty() const { return _map.empty(); }
+	[[nodiscard]] size_t size() const { return _map.size(); }
+
+	void clear() {
+		_trace.record(trace_clear, 0);
+		_map.clear();
+	}
+	pair<iterator, bool> insert(const value_type &value) {
+		_trace.record(trace_insert, trace_key(value.first));
+		return _map.insert(value);
+	}
+	pair<iterator, bool> insert(value_type &&value) {
+		_trace.record(trace_insert, trace_key(value.first));
+		return _map.insert(std::move(value));
+	}
+	void erase(iterator const &pos) {
+		if (pos != _map.end()) _trace.record(trace_erase, trace_key(pos->first));
+		_map.erase(pos);
+	}
+	size_t count(const Key &key) const {
+		_trace.record(trace_find, trace_key(key));
+		return _map.count(key);
+	}
+	iterator find(const Key &key) {
+		_trace.record(trace_find, trace_key(key));
+		return _map.find(key);
+	}
+	const_iterator find(const Key &key) const {
+		_trace.record(trace_find, trace_key(key));
+		return _map.find(key);
+	}
+
+	base_type &base() noexcept { return _map; }
+	const base_type &base() const noexcept { return _map; }
+	const trace_writer &trace() const noexcept { return _trace; }
+
+private:
+	base_type _map;
+	mutable trace_writer _trace;
+};
+
+}// namespace sjtu
+
+#endif
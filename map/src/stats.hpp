@@ -0,0 +1,87 @@
+#ifndef SJTU_STATS_HPP
+#define SJTU_STATS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+namespace sjtu {
+
+/**
+ * instrumentation of the containers, compiled in only when SJTU_STATS is
+ * defined before the first include. Each container then counts its own
+ * events, read through its stats(), and adds them to process-wide
+ * counters kept in stats_registry. Without SJTU_STATS the counting code
+ * compiles to nothing, stats() does not exist and the layouts are those of
+ * an uninstrumented build.
+ */
+class stat_counter {
+public:
+	// a counter that sums what is added, or keeps the largest value seen.
+	enum kind { sum, max };
+
+	explicit stat_counter(const char *name, kind k = sum) noexcept;
+	stat_counter(const stat_counter &) = delete;
+	stat_counter &operator=(const stat_counter &) = delete;
+
+	void add(size_t n) noexcept {
+		if (_kind == sum) {
+			_value.fetch_add(n, std::memory_order_relaxed);
+			return;
+		}
+		size_t cur = _value.load(std::memory_order_relaxed);
+		while (cur < n && !_value.compare_exchange_weak(cur, n, std::memory_order_relaxed)) {}
+	}
+	size_t value() const noexcept { return _value.load(std::memory_order_relaxed); }
+	const char *name() const noexcept { return _name; }
+	void reset() noexcept { _value.store(0, std::memory_order_relaxed); }
+
+private:
+	friend class stats_registry;
+
+	std::atomic<size_t> _value{0};
+	const char *_name;
+	kind _kind;
+	stat_counter *_next = nullptr;
+};
+
+/**
+ * every stat_counter of the program, in order of construction. Counters
+ * register themselves during static initialisation, so the list must not
+ * be walked before main.
+ */
+class stats_registry {
+public:
+	static stat_counter *find(const char *name) noexcept {
+		for (stat_counter *c = _head; c; c = c->_next)
+			if (!std::strcmp(c->_name, name)) return c;
+		return nullptr;
+	}
+	// 0 for a counter that does not exist, e.g. in a build without SJTU_STATS.
+	static size_t value(const char *name) noexcept {
+		stat_counter *c = find(name);
+		return c ? c->value() : 0;
+	}
+	// f(name, value) for every counter.
+	template<class F>
+	static void for_each(F &&f) {
+		for (stat_counter *c = _head; c; c = c->_next) f(c->name(), c->value());
+	}
+	static void reset() noexcept {
+		for (stat_counter *c = _head; c; c = c->_next) c->reset();
+	}
+
+private:
+	friend class stat_counter;
+
+	static inline stat_counter *_head = nullptr, *_tail = nullptr;
+};
+
+inline stat_counter::stat_counter(const char *name, kind k) noexcept : _name(name), _kind(k) {
+	(stats_registry::_tail ? stats_registry::_tail->_next : stats_registry::_head) = this;
+	stats_registry::_tail = this;
+}
+
+}// namespace sjtu
+
+#endif
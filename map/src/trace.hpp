@@ -0,0 +1,205 @@
+#ifndef SJTU_TRACE_HPP
+#define SJTU_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+namespace sjtu {
+
+/**
+ * operation traces, written by the recorded_* wrappers and read by the
+ * replay tool (trace/replay.cpp).
+ *
+ * A trace is a 24-byte header, the magic "STLTRACE", a version, the kind of
+ * container and the number of records, followed by one 64-bit record per
+ * operation: the operation in the top 4 bits, its key in the other 60. An
+ * integral key is stored as itself, offset so that the order of keys in
+ * (-2^59, 2^59) is kept; any other key as a 60-bit hash. The key of a
+ * vector operation is its index, that of a merge the size of the other
+ * queue.
+ */
+enum class trace_kind : uint8_t { vector = 1, map = 2, priority_queue = 3 };
+
+enum trace_op : unsigned {
+	// vector
+	trace_push_back = 0,
+	trace_pop_back,
+	trace_insert_at,
+	trace_erase_at,
+	trace_read,
+	trace_write,
+	// map
+	trace_insert = 0,
+	trace_erase,
+	trace_find,
+	trace_assign,
+	trace_clear = 15,
+	// priority_queue
+	trace_push = 0,
+	trace_pop,
+	trace_top,
+	trace_merge,
+};
+
+constexpr int trace_key_bits = 60;
+constexpr uint64_t trace_key_mask = (uint64_t(1) << trace_key_bits) - 1;
+
+template<class K>
+uint64_t trace_key(const K &key) {
+	if constexpr (std::is_integral_v<K>) {
+		if constexpr (std::is_signed_v<K>) return (uint64_t(int64_t(key)) + (uint64_t(1) << (trace_key_bits - 1))) & trace_key_mask;
+		else return uint64_t(key) & trace_key_mask;
+	} else if constexpr (requires { std::hash<K>{}(key); }) {
+		// spread the hash, as std::hash of small values is often the identity.
+		uint64_t h = std::hash<K>{}(key) * 0x9e3779b97f4a7c15ull;
+		return (h ^ h >> 29) & trace_key_mask;
+	} else {
+		return 0;
+	}
+}
+
+struct trace_header {
+	char magic[8];
+	uint32_t version;
+	uint8_t kind;
+	uint8_t reserved[3];
+	uint64_t count;
+};
+static_assert(sizeof(trace_header) == 24, "the header is part of the file format");
+
+/**
+ * appends records to a trace file through a shared mapping that doubles
+ * when full, so recording is a store and a bounds check. The header's count
+ * is brought up to date on every growth and when the writer closes, when
+ * the file is also cut to its exact length.
+ *
+ * Tracing must never break the traced program: if the file cannot be
+ * opened or grown, the writer stops recording and ok() turns false.
+ */
+class trace_writer {
+public:
+	trace_writer(const char *path, trace_kind kind) noexcept {
+		_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (_fd < 0) return;
+		if (!remap(first_bytes)) return;
+		trace_header *h = header();
+		std::memcpy(h->magic, "STLTRACE", 8);
+		h->version = 1;
+		h->kind = static_cast<uint8_t>(kind);
+	}
+	trace_writer(const trace_writer &) = delete;
+	trace_writer &operator=(const trace_writer &) = delete;
+	~trace_writer() { close(); }
+
+	void record(unsigned op, uint64_t key) noexcept {
+		if (_cur == _end && !grow()) return;
+		*_cur++ = uint64_t(op) << trace_key_bits | (key & trace_key_mask);
+	}
+
+	bool ok() const noexcept { return _base != nullptr; }
+	uint64_t count() const noexcept { return _base ? uint64_t(_cur - records()) : 0; }
+
+	void close() noexcept {
+		if (_base) {
+			uint64_t n = count();
+			header()->count = n;
+			::munmap(_base, _bytes);
+			_base = nullptr;
+			if (::ftruncate(_fd, sizeof(trace_header) + n * sizeof(uint64_t))) {}
+		}
+		if (_fd >= 0) ::close(_fd);
+		_fd = -1;
+	}
+
+private:
+	static constexpr size_t first_bytes = size_t(1) << 20;
+
+	int _fd = -1;
+	void *_base = nullptr;
+	size_t _bytes = 0;
+	uint64_t *_cur = nullptr, *_end = nullptr;
+
+	trace_header *header() const noexcept { return static_cast<trace_header *>(_base); }
+	uint64_t *records() const noexcept { return reinterpret_cast<uint64_t *>(static_cast<char *>(_base) + sizeof(trace_header)); }
+
+	bool remap(size_t bytes) noexcept {
+		uint64_t n = count();
+		if (_base) {
+			header()->count = n;
+			::munmap(_base, _bytes);
+			_base = nullptr;
+		}
+		void *p = MAP_FAILED;
+		if (!::ftruncate(_fd, bytes)) p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+		if (p == MAP_FAILED) {
+			_cur = _end = nullptr;
+			return false;
+		}
+		_base = p;
+		_bytes = bytes;
+		_cur = records() + n;
+		_end = reinterpret_cast<uint64_t *>(static_cast<char *>(p) + bytes);
+		return true;
+	}
+	bool grow() noexcept { return _base && remap(2 * _bytes); }
+};
+
+/**
+ * a trace mapped read-only. ok() is false if the file is missing, is not a
+ * trace of a known kind or is shorter than its count says.
+ */
+class trace_reader {
+public:
+	explicit trace_reader(const char *path) noexcept {
+		int fd = ::open(path, O_RDONLY);
+		if (fd < 0) return;
+		struct stat st;
+		if (!::fstat(fd, &st) && size_t(st.st_size) >= sizeof(trace_header)) {
+			void *p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (p != MAP_FAILED) {
+				_base = p;
+				_bytes = st.st_size;
+			}
+		}
+		::close(fd);
+		if (!_base) return;
+		const trace_header *h = static_cast<const trace_header *>(_base);
+		if (std::memcmp(h->magic, "STLTRACE", 8) || h->version != 1 ||
+			h->kind < uint8_t(trace_kind::vector) || h->kind > uint8_t(trace_kind::priority_queue) ||
+			h->count > (_bytes - sizeof(trace_header)) / sizeof(uint64_t)) {
+			::munmap(_base, _bytes);
+			_base = nullptr;
+		}
+	}
+	trace_reader(const trace_reader &) = delete;
+	trace_reader &operator=(const trace_reader &) = delete;
+	~trace_reader() {
+		if (_base) ::munmap(_base, _bytes);
+	}
+
+	bool ok() const noexcept { return _base != nullptr; }
+	trace_kind kind() const noexcept { return trace_kind(static_cast<const trace_header *>(_base)->kind); }
+	uint64_t size() const noexcept { return static_cast<const trace_header *>(_base)->count; }
+	const uint64_t *records() const noexcept {
+		return reinterpret_cast<const uint64_t *>(static_cast<const char *>(_base) + sizeof(trace_header));
+	}
+
+	static unsigned op(uint64_t record) noexcept { return unsigned(record >> trace_key_bits); }
+	static uint64_t key(uint64_t record) noexcept { return record & trace_key_mask; }
+
+private:
+	void *_base = nullptr;
+	size_t _bytes = 0;
+};
+
+}// namespace sjtu
+
+#endif
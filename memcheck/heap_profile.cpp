@@ -0,0 +1,124 @@
+// heap allocations per operation of each container, counted by replacing
+// the global operator new and delete. Every row repeats one operation n
+// times on a fresh container and reports the calls to operator new and
+// the bytes asked for, divided by n; the rows on an arena show what is
+// left once the nodes come from sjtu::arena.
+//
+// usage: stlite-heap-profile [n]
+#include "arena.hpp"
+#include "dary_heap.hpp"
+#include "map.hpp"
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+#include "vector.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+
+namespace {
+
+size_t allocations = 0, bytes = 0;
+
+void *counted(size_t size, size_t align = 0) {
+	++allocations;
+	bytes += size;
+	void *p = align ? std::aligned_alloc(align, (size + align - 1) / align * align) : std::malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+}// namespace
+
+void *operator new(size_t size) { return counted(size); }
+void *operator new[](size_t size) { return counted(size); }
+void *operator new(size_t size, std::align_val_t align) { return counted(size, (size_t) align); }
+void *operator new[](size_t size, std::align_val_t align) { return counted(size, (size_t) align); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+template<typename Type>
+using std_alloc = std::allocator<Type>;
+template<typename Type>
+using arena_alloc = sjtu::polymorphic_allocator<Type>;
+
+// setup builds the container outside the count, op(c, i) runs n times inside it.
+template<class C, class Setup, class Op>
+void row(const char *container, const char *operation, int n, Setup setup, Op op) {
+	C c;
+	setup(c);
+	size_t a0 = allocations, b0 = bytes;
+	for (int i = 0; i < n; ++i) op(c, i);
+	printf("%-36s %-12s %10.3f %12.1f\n", container, operation,
+		   (double) (allocations - a0) / n, (double) (bytes - b0) / n);
+}
+
+int key(int i) { return (int) ((unsigned) i * 2654435761u >> 1); }
+
+template<class V>
+void vector_rows(const char *name, int n) {
+	auto none = [](V &) {};
+	auto fill = [n](V &v) {
+		for (int i = 0; i < n; ++i) v.push_back(i);
+	};
+	row<V>(name, "push_back", n, none, [](V &v, int i) { v.push_back(i); });
+	row<V>(name, "pop_back", n, fill, [](V &v, int) { v.pop_back(); });
+	row<V>(name, "copy", 100, fill, [](V &v, int) { V w(v); });
+}
+
+template<class M>
+void map_rows(const char *name, int n) {
+	auto none = [](M &) {};
+	auto fill = [n](M &m) {
+		for (int i = 0; i < n; ++i) m[key(i)] = i;
+	};
+	row<M>(name, "insert", n, none, [](M &m, int i) { m[key(i)] = i; });
+	row<M>(name, "find", n, fill, [](M &m, int i) { (void) m.find(key(i)); });
+	row<M>(name, "erase", n, fill, [](M &m, int i) { m.erase(m.find(key(i))); });
+	row<M>(name, "copy", 10, fill, [](M &m, int) { M c(m); });
+}
+
+template<class Q>
+void queue_rows(const char *name, int n) {
+	auto none = [](Q &) {};
+	auto fill = [n](Q &q) {
+		for (int i = 0; i < n; ++i) q.push(key(i));
+	};
+	row<Q>(name, "push", n, none, [](Q &q, int i) { q.push(key(i)); });
+	row<Q>(name, "pop", n, fill, [](Q &q, int) { q.pop(); });
+	row<Q>(name, "merge", 100, none, [](Q &q, int i) {
+		Q other;
+		for (int k = 0; k < 100; ++k) other.push(key(i * 100 + k));
+		q.merge(other);
+	});
+}
+
+}// namespace
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? atoi(argv[1]) : 100000;
+	printf("%-36s %-12s %10s %12s\n", "container", "operation", "allocs/op", "bytes/op");
+
+	vector_rows<sjtu::vector<int>>("vector<int>", n);
+	map_rows<sjtu::map<int, int>>("map<int, int>", n);
+	queue_rows<sjtu::priority_queue<int>>("priority_queue<int> (node_pool)", n);
+	queue_rows<sjtu::priority_queue<int, std::less<int>, sjtu::leftist_heap, std_alloc>>("priority_queue<int> (std::allocator)", n);
+	queue_rows<sjtu::priority_queue<int, std::less<int>, sjtu::pairing_heap>>("priority_queue<int> (pairing)", n);
+	queue_rows<sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<4>>>("priority_queue<int> (dary<4>)", n);
+
+	sjtu::arena a(1 << 20);
+	sjtu::resource_scope scope(&a);
+	vector_rows<sjtu::vector<int, arena_alloc<int>>>("vector<int> (arena)", n);
+	map_rows<sjtu::map<int, int, std::less<int>, arena_alloc>>("map<int, int> (arena)", n);
+	queue_rows<sjtu::priority_queue<int, std::less<int>, sjtu::leftist_heap, arena_alloc>>("priority_queue<int> (arena)", n);
+	return 0;
+}
@@ -0,0 +1,58 @@
+# memory checking. Three more build types instrument every test:
+#   Asan      -fsanitize=address, which reports leaks at exit too;
+#   Ubsan     -fsanitize=undefined, failing on the first report;
+#   Valgrind  -O1 -g, with the *.memcheck cases run under valgrind.
+# The *.memcheck cases carry the label memcheck (ctest -L memcheck), and
+# the timeouts grow with the slowdown of the build type. CMakePresets.json
+# has a configure and a test preset for each.
+#
+# stlite-heap-profile counts the heap allocations of each container
+# operation; the heap_profile target builds and runs it.
+
+set(CMAKE_CXX_FLAGS_ASAN "-O1 -g -fsanitize=address -fno-omit-frame-pointer")
+set(CMAKE_EXE_LINKER_FLAGS_ASAN "-fsanitize=address")
+set(CMAKE_CXX_FLAGS_UBSAN "-O1 -g -fsanitize=undefined -fno-sanitize-recover=undefined")
+set(CMAKE_EXE_LINKER_FLAGS_UBSAN "-fsanitize=undefined")
+set(CMAKE_CXX_FLAGS_VALGRIND "-O1 -g")
+
+string(TOUPPER "${CMAKE_BUILD_TYPE}" build_type)
+set(STLITE_TIMEOUT_SCALE 1)
+set(STLITE_MEMCHECK_LAUNCHER "")
+if (build_type STREQUAL "ASAN")
+    set(STLITE_TIMEOUT_SCALE 10)
+elseif (build_type STREQUAL "UBSAN")
+    set(STLITE_TIMEOUT_SCALE 5)
+elseif (build_type STREQUAL "VALGRIND")
+    find_program(VALGRIND valgrind)
+    if (NOT VALGRIND)
+        message(FATAL_ERROR "the Valgrind build type needs valgrind")
+    endif ()
+    set(STLITE_TIMEOUT_SCALE 50)
+    set(STLITE_MEMCHECK_LAUNCHER "${VALGRIND} -q --error-exitcode=99 --leak-check=full --errors-for-leak-kinds=definite,indirect ")
+endif ()
+
+# stlite_launcher(<var> <test>): what the command of <test> runs its program under.
+function(stlite_launcher var name)
+    if (name MATCHES "\\.memcheck$")
+        set(${var} "${STLITE_MEMCHECK_LAUNCHER}" PARENT_SCOPE)
+    else ()
+        set(${var} "" PARENT_SCOPE)
+    endif ()
+endfunction()
+
+# stlite_memcheck_case(<test>): labels and timeout of a data case, once added.
+function(stlite_memcheck_case name)
+    get_test_property(${name} TIMEOUT timeout)
+    if (timeout)
+        math(EXPR timeout "${timeout} * ${STLITE_TIMEOUT_SCALE}")
+        set_property(TEST ${name} PROPERTY TIMEOUT ${timeout})
+    endif ()
+    if (name MATCHES "\\.memcheck$")
+        set_property(TEST ${name} APPEND PROPERTY LABELS memcheck)
+    endif ()
+endfunction()
+
+add_executable(stlite-heap-profile "${CMAKE_CURRENT_LIST_DIR}/heap_profile.cpp")
+target_include_directories(stlite-heap-profile PRIVATE
+        ${CMAKE_CURRENT_SOURCE_DIR}/vector/src ${CMAKE_CURRENT_SOURCE_DIR}/map/src ${CMAKE_CURRENT_SOURCE_DIR}/priority_queue/src)
+add_custom_target(heap_profile COMMAND stlite-heap-profile DEPENDS stlite-heap-profile)
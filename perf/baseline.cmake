@@ -0,0 +1,10 @@
+# cmake -DRESULTS=<dir> -DBASELINE=<file> -P baseline.cmake
+# replaces the baseline with the results of the last perf run.
+file(GLOB results "${RESULTS}/*.txt")
+list(SORT results)
+set(text "# case wall_ms rss_kb, written by the perf_baseline target\n")
+foreach (result ${results})
+    file(READ ${result} line)
+    string(APPEND text "${line}")
+endforeach ()
+file(WRITE ${BASELINE} "${text}")
@@ -0,0 +1,49 @@
+# perf tests. With STLITE_PERF on, every data case is also built at -O3
+# -march=native, and at -O3 -march=native with LTO where the compiler
+# supports it, as <test>-O3 and <test>-lto. Those run under the label perf
+# (ctest -L perf) through stlite-perf-runner, which checks the output like
+# the plain test and fails a case whose best wall time or peak RSS exceeds
+# its line in STLITE_PERF_BASELINE by more than STLITE_PERF_THRESHOLD
+# percent. The numbers of the last run are written to <build>/perf; the
+# perf_baseline target copies them into the baseline.
+
+option(STLITE_PERF "build the -O3 and LTO perf tests" OFF)
+set(STLITE_PERF_THRESHOLD 25 CACHE STRING "percent a perf case may exceed its baseline by")
+set(STLITE_PERF_RUNS 3 CACHE STRING "runs per perf case; the best wall time counts")
+set(STLITE_PERF_BASELINE "${CMAKE_CURRENT_LIST_DIR}/baseline.txt" CACHE FILEPATH "perf baseline")
+
+if (STLITE_PERF)
+    include(CheckIPOSupported)
+    check_ipo_supported(RESULT STLITE_PERF_LTO OUTPUT lto_error)
+    if (NOT STLITE_PERF_LTO)
+        message(STATUS "perf: no LTO variants, ${lto_error}")
+    endif ()
+    file(MAKE_DIRECTORY "${CMAKE_BINARY_DIR}/perf")
+    add_executable(stlite-perf-runner "${CMAKE_CURRENT_LIST_DIR}/runner.cpp")
+    add_custom_target(perf_baseline
+            COMMAND ${CMAKE_COMMAND} -DRESULTS=${CMAKE_BINARY_DIR}/perf -DBASELINE=${STLITE_PERF_BASELINE}
+            -P "${CMAKE_CURRENT_LIST_DIR}/baseline.cmake"
+            COMMENT "Writing the perf results into ${STLITE_PERF_BASELINE}")
+endif ()
+
+# stlite_perf_case(<test> <source> <answer>): the perf variants of a data case.
+function(stlite_perf_case name source answer)
+    if (NOT STLITE_PERF)
+        return()
+    endif ()
+    set(variants O3)
+    if (STLITE_PERF_LTO)
+        list(APPEND variants lto)
+    endif ()
+    foreach (variant ${variants})
+        set(target ${name}-${variant})
+        add_executable(${target} ${source})
+        target_compile_options(${target} PRIVATE -O3 -march=native)
+        if (variant STREQUAL lto)
+            set_property(TARGET ${target} PROPERTY INTERPROCEDURAL_OPTIMIZATION ON)
+        endif ()
+        add_test(NAME ${target}
+                COMMAND bash -c "set -o pipefail; $<TARGET_FILE:stlite-perf-runner> ${target} ${STLITE_PERF_BASELINE} ${CMAKE_BINARY_DIR}/perf/${target}.txt ${STLITE_PERF_THRESHOLD} ${STLITE_PERF_RUNS} -- $<TARGET_FILE:${target}> | diff -Zb ${answer} -")
+        set_tests_properties(${target} PROPERTIES LABELS perf TIMEOUT 120 RUN_SERIAL ON)
+    endforeach ()
+endfunction()
@@ -0,0 +1,105 @@
+// runs a test program a few times and checks its wall time and peak RSS
+// against a stored baseline. The program's output of the first run goes to
+// stdout, to be diffed like any other test; the report goes to stderr.
+//
+// usage: stlite-perf-runner <case> <baseline> <result> <threshold %> <runs> -- <program> [args]
+//
+// baseline holds lines "case wall_ms rss_kb", '#' starting a comment. A case
+// regresses when either number exceeds its baseline by more than threshold
+// percent, plus a little slack for noise on short cases. A case without a
+// baseline always passes. result gets this run's line, in the same format.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr double slack_ms = 5, slack_kb = 1024;
+
+struct sample {
+	double wall_ms;
+	long rss_kb;
+};
+
+// one run; false if the program could not be run or failed.
+bool run(char **argv, bool quiet, sample &out) {
+	auto start = std::chrono::steady_clock::now();
+	pid_t pid = fork();
+	if (pid < 0) return false;
+	if (!pid) {
+		if (quiet) {
+			int null = open("/dev/null", O_WRONLY);
+			if (null >= 0) dup2(null, STDOUT_FILENO);
+		}
+		execv(argv[0], argv);
+		_exit(127);
+	}
+	int status;
+	rusage usage;
+	if (wait4(pid, &status, 0, &usage) != pid) return false;
+	out.wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	out.rss_kb = usage.ru_maxrss;
+	return WIFEXITED(status) && !WEXITSTATUS(status);
+}
+
+bool find_baseline(const char *path, const std::string &name, sample &out) {
+	FILE *f = fopen(path, "r");
+	if (!f) return false;
+	char line[512], key[256];
+	bool found = false;
+	while (!found && fgets(line, sizeof(line), f)) {
+		if (line[0] == '#') continue;
+		found = sscanf(line, "%255s %lf %ld", key, &out.wall_ms, &out.rss_kb) == 3 && name == key;
+	}
+	fclose(f);
+	return found;
+}
+
+}// namespace
+
+int main(int argc, char **argv) {
+	if (argc < 8 || strcmp(argv[6], "--")) {
+		fprintf(stderr, "usage: %s <case> <baseline> <result> <threshold %%> <runs> -- <program> [args]\n", argv[0]);
+		return 2;
+	}
+	std::string name = argv[1];
+	double threshold = atof(argv[4]) / 100;
+	int runs = atoi(argv[5]);
+	if (runs < 1) runs = 1;
+
+	// the best wall time is the least noisy; RSS barely varies between runs.
+	sample best{0, 0};
+	for (int i = 0; i < runs; ++i) {
+		sample s;
+		fflush(stdout);
+		if (!run(argv + 7, i > 0, s)) {
+			fprintf(stderr, "%s: the program failed\n", name.c_str());
+			return 1;
+		}
+		if (!i || s.wall_ms < best.wall_ms) best.wall_ms = s.wall_ms;
+		if (s.rss_kb > best.rss_kb) best.rss_kb = s.rss_kb;
+	}
+
+	if (FILE *f = fopen(argv[3], "w")) {
+		fprintf(f, "%s %.1f %ld\n", name.c_str(), best.wall_ms, best.rss_kb);
+		fclose(f);
+	}
+
+	sample base;
+	if (!find_baseline(argv[2], name, base)) {
+		fprintf(stderr, "%s: %.1f ms, %ld KiB, no baseline\n", name.c_str(), best.wall_ms, best.rss_kb);
+		return 0;
+	}
+	bool slow = best.wall_ms > base.wall_ms * (1 + threshold) + slack_ms;
+	bool fat = best.rss_kb > base.rss_kb * (1 + threshold) + slack_kb;
+	fprintf(stderr, "%s: %.1f ms (baseline %.1f), %ld KiB (baseline %ld)%s%s\n", name.c_str(),
+			best.wall_ms, base.wall_ms, best.rss_kb, base.rss_kb,
+			slow ? ", too slow" : "", fat ? ", too much memory" : "");
+	return slow || fat;
+}
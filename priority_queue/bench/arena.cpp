@@ -0,0 +1,81 @@
+// request-scoped work: each request builds a few small queues, merges them,
+// pops half and throws everything away. The queues allocate from the
+// default allocators, or from an arena released (or reset) after every
+// request.
+// Times are ns per element pushed.
+//
+// usage: priority_queue-bench-arena [elements per request] [requests]
+#include "arena.hpp"
+#include "dary_heap.hpp"
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+
+using clock_type = std::chrono::steady_clock;
+
+unsigned long long seed = 88172645463325252ull;
+unsigned Rand() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (unsigned) (seed >> 32);
+}
+
+template<typename Type>
+using std_alloc = std::allocator<Type>;
+template<typename Type>
+using arena_alloc = sjtu::polymorphic_allocator<Type>;
+
+template<class Q>
+long long request(int n) {
+	Q parts[4];
+	for (int i = 0; i < n; ++i) parts[i % 4].push((int) Rand());
+	for (int i = 1; i < 4; ++i) parts[0].merge(parts[i]);
+	long long sink = 0;
+	for (int i = 0; i < n / 2; ++i) {
+		sink += parts[0].top();
+		parts[0].pop();
+	}
+	return sink;
+}
+
+template<class Q>
+void run(const char *name, int n, int requests, sjtu::arena *a, bool reset = false) {
+	seed = 88172645463325252ull;
+	long long sink = 0;
+	auto start = clock_type::now();
+	for (int r = 0; r < requests; ++r) {
+		if (a) {
+			{
+				sjtu::resource_scope scope(a);
+				sink += request<Q>(n);
+			}
+			reset ? a->reset() : a->release();
+		} else {
+			sink += request<Q>(n);
+		}
+	}
+	double t = std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / ((double) n * requests);
+	printf("%-30s %10.1f%s\n", name, t, sink == 42 ? " " : "");
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? atoi(argv[1]) : 1000;
+	int requests = argc > 2 ? atoi(argv[2]) : 2000;
+	sjtu::arena a;
+	printf("%d elements per request, %d requests, ns per element\n", n, requests);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::leftist_heap, std_alloc>>("leftist, std::allocator", n, requests, nullptr);
+	run<sjtu::priority_queue<int>>("leftist, node_pool", n, requests, nullptr);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::leftist_heap, arena_alloc>>("leftist, arena", n, requests, &a);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::leftist_heap, arena_alloc>>("leftist, arena, reset", n, requests, &a, true);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::pairing_heap, std_alloc>>("pairing, std::allocator", n, requests, nullptr);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::pairing_heap, arena_alloc>>("pairing, arena", n, requests, &a);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<4>, std_alloc>>("dary<4>, std::allocator", n, requests, nullptr);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<4>, arena_alloc>>("dary<4>, arena", n, requests, &a);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<4>, arena_alloc>>("dary<4>, arena, reset", n, requests, &a, true);
+	return 0;
+}
@@ -0,0 +1,68 @@
+// building a queue of n keys, random and then descending (the worst order
+// for pushes into a leftist heap): n pushes against the range
+// constructor, for each policy and for std::priority_queue.
+//
+// usage: priority_queue-bench-build [n] [rounds]
+#include "dary_heap.hpp"
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+
+unsigned long long seed = 88172645463325252ull;
+int Rand() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (int) (seed >> 33);
+}
+
+template<class F>
+double ns_per(long long ops, F f) {
+	auto start = clock_type::now();
+	f();
+	return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / ops;
+}
+
+template<class Q>
+void run(const char *name, int rounds, const std::vector<int> &keys) {
+	long long sink = 0;
+	double pushes = ns_per((long long) rounds * keys.size(), [&] {
+		for (int r = 0; r < rounds; ++r) {
+			Q q;
+			for (int k : keys) q.push(k);
+			sink += q.top();
+		}
+	});
+	double range = ns_per((long long) rounds * keys.size(), [&] {
+		for (int r = 0; r < rounds; ++r) {
+			Q q(keys.begin(), keys.end());
+			sink += q.top();
+		}
+	});
+	printf("%-24s %12.1f %12.1f %8.2fx%s\n", name, pushes, range, pushes / range, sink == 42 ? " " : "");
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1 << 22;
+	int rounds = argc > 2 ? std::atoi(argv[2]) : 3;
+	std::vector<int> keys(n);
+	for (int &k : keys) k = Rand();
+	for (const char *order : {"random", "descending"}) {
+		if (order[0] == 'd') std::sort(keys.begin(), keys.end(), std::greater<int>());
+		printf("n = %d %s keys, %d rounds, ns per element (including destruction)\n", n, order, rounds);
+		printf("%-24s %12s %12s %9s\n", "", "n pushes", "range ctor", "speedup");
+		run<sjtu::priority_queue<int>>("sjtu::priority_queue", rounds, keys);
+		run<sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<>>>("  dary_heap<4>", rounds, keys);
+		run<sjtu::priority_queue<int, std::less<int>, sjtu::pairing_heap>>("  pairing_heap", rounds, keys);
+		run<std::priority_queue<int>>("std::priority_queue", rounds, keys);
+	}
+	return 0;
+}
@@ -0,0 +1,73 @@
+// a double-ended queue of about n elements, as in admission control: each
+// step pushes one element and pops either the smallest or the largest.
+// minmax_heap against std::multiset.
+//
+// usage: priority_queue-bench-minmax [n] [steps]
+#include "minmax_heap.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <set>
+
+using clock_type = std::chrono::steady_clock;
+
+unsigned long long seed = 88172645463325252ull;
+int Rand() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (int) (seed >> 33);
+}
+
+template<class F>
+double ns_per(long long ops, F f) {
+	auto start = clock_type::now();
+	f();
+	return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / ops;
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+	int steps = argc > 2 ? std::atoi(argv[2]) : 1 << 22;
+	int *keys = new int[steps];
+	for (int i = 0; i < steps; ++i) keys[i] = Rand();
+
+	long long sink = 0;
+	sjtu::minmax_heap<int> heap;
+	std::multiset<int> set;
+	for (int i = 0; i < n; ++i) {
+		int k = Rand();
+		heap.push(k);
+		set.insert(k);
+	}
+	double t_heap = ns_per(steps, [&] {
+		for (int i = 0; i < steps; ++i) {
+			heap.push(keys[i]);
+			if (keys[i] & 1) {
+				sink += heap.top_min();
+				heap.pop_min();
+			} else {
+				sink += heap.top_max();
+				heap.pop_max();
+			}
+		}
+	});
+	double t_set = ns_per(steps, [&] {
+		for (int i = 0; i < steps; ++i) {
+			set.insert(keys[i]);
+			if (keys[i] & 1) {
+				sink += *set.begin();
+				set.erase(set.begin());
+			} else {
+				sink += *set.rbegin();
+				set.erase(std::prev(set.end()));
+			}
+		}
+	});
+	printf("n = %d, %d steps, ns per push + pop\n", n, steps);
+	printf("%-16s %8.1f\n", "minmax_heap", t_heap);
+	printf("%-16s %8.1f  (%.2fx)\n", "std::multiset", t_set, t_set / t_heap);
+	delete[] keys;
+	return sink == 42;
+}
@@ -0,0 +1,85 @@
+// throughput of multi_queue against one sjtu::priority_queue behind a
+// mutex, from one thread up to all hardware threads. Every thread
+// alternates push and pop on a queue kept at about n elements.
+//
+// usage: priority_queue-bench-multi_queue [n] [millis per point] [max threads]
+#include "dary_heap.hpp"
+#include "multi_queue.hpp"
+#include "priority_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+using policy = sjtu::dary_heap<4>;
+
+struct xorshift {
+	unsigned long long s;
+	unsigned long long operator()() {
+		s ^= s << 13;
+		s ^= s >> 7;
+		s ^= s << 17;
+		return s;
+	}
+};
+
+// op(key) pushes key and pops one element.
+template<class Op>
+double run(int threads, int millis, Op op) {
+	std::atomic<bool> stop{false};
+	std::atomic<unsigned long long> total{0};
+	std::vector<std::thread> pool;
+	for (int t = 0; t < threads; ++t)
+		pool.emplace_back([&, t] {
+			xorshift rng{0x9e3779b97f4a7c15ull * (t + 1)};
+			unsigned long long ops = 0;
+			while (!stop.load(std::memory_order_relaxed)) {
+				for (int i = 0; i < 256; ++i) op((int) (rng() >> 33));
+				ops += 512;
+			}
+			total += ops;
+		});
+	auto start = clock_type::now();
+	std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+	stop = true;
+	for (auto &th : pool) th.join();
+	double sec = std::chrono::duration<double>(clock_type::now() - start).count();
+	return total.load() / sec;
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+	int millis = argc > 2 ? std::atoi(argv[2]) : 300;
+	int hw = argc > 3 ? std::atoi(argv[3]) : (int) std::thread::hardware_concurrency();
+	if (hw <= 0) hw = 1;
+
+	printf("%8s %8s %16s %16s %8s\n", "threads", "shards", "multi ops/s", "mutex ops/s", "ratio");
+	for (int t = 1;; t = t * 2 > hw ? hw : t * 2) {
+		sjtu::multi_queue<int, std::less<int>, policy> multi(t);
+		sjtu::priority_queue<int, std::less<int>, policy> locked;
+		std::mutex mtx;
+		xorshift rng{42};
+		for (int i = 0; i < n; ++i) {
+			int key = (int) (rng() >> 33);
+			multi.push(key);
+			locked.push(key);
+		}
+		double m = run(t, millis, [&](int key) {
+			int out;
+			multi.push(key);
+			multi.try_pop(out);
+		});
+		double l = run(t, millis, [&](int key) {
+			std::lock_guard<std::mutex> lock(mtx);
+			locked.push(key);
+			locked.pop();
+		});
+		printf("%8d %8zu %16.0f %16.0f %8.2f\n", t, multi.shards(), m, l, m / l);
+		if (t == hw) break;
+	}
+	return 0;
+}
@@ -0,0 +1,95 @@
+// throughput of the priority_queue policies against std::priority_queue:
+// n random pushes followed by n pops, a steady-state mix of push + pop on
+// a queue of n and, for the node-based heaps, merging n / 64 small queues
+// into one, and copying and destroying the result.
+//
+// usage: priority_queue-bench-push_pop [n] [rounds]
+#include "dary_heap.hpp"
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <queue>
+
+using clock_type = std::chrono::steady_clock;
+
+unsigned long long seed = 88172645463325252ull;
+int Rand() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (int) (seed >> 33);
+}
+
+template<class F>
+double ns_per(long long ops, F f) {
+	auto start = clock_type::now();
+	f();
+	return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / ops;
+}
+
+template<class Q, bool mergeable = false>
+void run(const char *name, int n, int rounds, const int *keys) {
+	long long sink = 0;
+	double fill = ns_per(2ll * n * rounds, [&] {
+		for (int r = 0; r < rounds; ++r) {
+			Q q;
+			for (int i = 0; i < n; ++i) q.push(keys[i]);
+			while (!q.empty()) {
+				sink += q.top();
+				q.pop();
+			}
+		}
+	});
+	Q q;
+	for (int i = 0; i < n; ++i) q.push(keys[i]);
+	double steady = ns_per((long long) n * rounds, [&] {
+		for (int r = 0; r < rounds; ++r)
+			for (int i = 0; i < n; ++i) {
+				q.push(q.top() - keys[i] % 1024);
+				q.pop();
+			}
+	});
+	sink += q.top();
+	printf("%-24s %14.1f %14.1f", name, fill, steady);
+	if constexpr (mergeable) {
+		Q all;
+		double merge = ns_per(n, [&] {
+			for (int i = 0; i < n; i += 64) {
+				Q part;
+				for (int j = i; j < i + 64 && j < n; ++j) part.push(keys[j]);
+				all.merge(part);
+			}
+		});
+		double copy = ns_per(n, [&] {
+			Q dup(all);
+			sink += dup.size();
+		});
+		printf(" %14.1f %14.1f", merge, copy);
+	}
+	printf("%s\n", sink == 42 ? " " : "");
+}
+
+template<typename Type>
+using std_alloc = std::allocator<Type>;
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+	int rounds = argc > 2 ? std::atoi(argv[2]) : 4;
+	int *keys = new int[n];
+	for (int i = 0; i < n; ++i) keys[i] = Rand();
+	printf("n = %d, %d rounds, ns per element\n", n, rounds);
+	printf("%-24s %14s %14s %14s %14s\n", "", "push+pop", "steady", "merge", "copy+free");
+	run<sjtu::priority_queue<int>, true>("sjtu::priority_queue", n, rounds, keys);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::leftist_heap, std_alloc>, true>("  std::allocator", n, rounds, keys);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::lazy_leftist_heap>, true>("  lazy_leftist_heap", n, rounds, keys);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::pairing_heap>, true>("  pairing_heap", n, rounds, keys);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<2>>>("  dary_heap<2>", n, rounds, keys);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<4>>>("  dary_heap<4>", n, rounds, keys);
+	run<sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<8>>>("  dary_heap<8>", n, rounds, keys);
+	run<std::priority_queue<int>>("std::priority_queue", n, rounds, keys);
+	delete[] keys;
+	return 0;
+}
@@ -0,0 +1,80 @@
+// the hold model on monotone keys, as in an event queue or Dijkstra: a
+// queue of n elements, each step pops the smallest key and pushes it back
+// plus a random delay. radix_heap against the comparison-based queues
+// holding (key, value) pairs.
+//
+// usage: priority_queue-bench-radix [n] [steps] [max delay]
+#include "dary_heap.hpp"
+#include "priority_queue.hpp"
+#include "radix_heap.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+using clock_type = std::chrono::steady_clock;
+using item = std::pair<unsigned, int>;
+
+unsigned long long seed = 88172645463325252ull;
+unsigned Rand() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (unsigned) (seed >> 32);
+}
+
+template<class F>
+double ns_per(long long ops, F f) {
+	auto start = clock_type::now();
+	f();
+	return std::chrono::duration<double, std::nano>(clock_type::now() - start).count() / ops;
+}
+
+template<class Q>
+void run(const char *name, int n, int steps, const unsigned *delay) {
+	Q q;
+	for (int i = 0; i < n; ++i) q.push(item(delay[i], i));
+	long long sink = 0;
+	double t = ns_per(steps, [&] {
+		for (int i = 0; i < steps; ++i) {
+			item e = q.top();
+			q.pop();
+			sink += e.second;
+			q.push(item(e.first + delay[i], e.second));
+		}
+	});
+	printf("%-24s %10.1f%s\n", name, t, sink == 42 ? " " : "");
+}
+
+void run_radix(int n, int steps, const unsigned *delay) {
+	sjtu::radix_heap<unsigned, int> q;
+	for (int i = 0; i < n; ++i) q.push(delay[i], i);
+	long long sink = 0;
+	double t = ns_per(steps, [&] {
+		for (int i = 0; i < steps; ++i) {
+			unsigned key = q.top().first;
+			int value = q.top().second;
+			q.pop();
+			sink += value;
+			q.push(key + delay[i], value);
+		}
+	});
+	printf("%-24s %10.1f%s\n", "radix_heap", t, sink == 42 ? " " : "");
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+	int steps = argc > 2 ? std::atoi(argv[2]) : 1 << 23;
+	unsigned range = argc > 3 ? (unsigned) std::atoll(argv[3]) : 1u << 16;
+	std::vector<unsigned> delay(steps > n ? steps : n);
+	for (unsigned &d : delay) d = Rand() % range;
+	printf("n = %d, %d steps, delays below %u, ns per step\n", n, steps, range);
+	run_radix(n, steps, delay.data());
+	run<sjtu::priority_queue<item, std::greater<item>, sjtu::dary_heap<4>>>("dary_heap<4>", n, steps, delay.data());
+	run<sjtu::priority_queue<item, std::greater<item>>>("sjtu::priority_queue", n, steps, delay.data());
+	run<std::priority_queue<item, std::vector<item>, std::greater<item>>>("std::priority_queue", n, steps, delay.data());
+	return 0;
+}
@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "arena.hpp"
+#include "dary_heap.hpp"
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+#include "vector.hpp"
+
+// counts what goes through it, to see that the containers allocate from
+// the default resource and give everything back.
+struct counting_resource : sjtu::memory_resource {
+	long live = 0, calls = 0;
+
+protected:
+	void *do_allocate(size_t bytes, size_t align) override {
+		++live, ++calls;
+		return sjtu::new_delete_resource()->allocate(bytes, align);
+	}
+	void do_deallocate(void *p, size_t bytes, size_t align) noexcept override {
+		--live;
+		sjtu::new_delete_resource()->deallocate(p, bytes, align);
+	}
+};
+
+template<class T>
+T Make(int x) { return T(x); }
+template<>
+std::string Make<std::string>(int x) { return std::to_string(x); }
+
+// one request: fill a few queues, merge them and drain the result.
+template<class Q, class T = int>
+bool Request(unsigned seed)
+{
+	srand(seed);
+	Q parts[4];
+	for (int i = 0; i < 3000; ++i) parts[rand() % 4].push(Make<T>(rand() % 10000));
+	for (int i = 1; i < 4; ++i) parts[0].merge(parts[i]);
+	Q copy(parts[0]);
+	if (copy.size() != 3000) return false;
+	T last = copy.top();
+	for (; !copy.empty(); copy.pop()) {
+		if (last < copy.top()) return false;
+		last = copy.top();
+	}
+	return true;
+}
+
+template<class Q, class T = int>
+bool Exercise()
+{
+	bool ok = true;
+	sjtu::arena a;
+	for (unsigned seed = 0; seed < 5; ++seed) {
+		{
+			sjtu::resource_scope scope(&a);
+			ok &= Request<Q, T>(seed);
+		}
+		a.release();
+	}
+	counting_resource counter;
+	{
+		sjtu::resource_scope scope(&counter);
+		ok &= Request<Q, T>(7);
+	}
+	return ok && counter.calls && !counter.live;
+}
+
+template<typename Type>
+using arena_alloc = sjtu::polymorphic_allocator<Type>;
+
+int main()
+{
+	std::cout << "Testing the arena...";
+	bool ok = Exercise<sjtu::priority_queue<int, std::less<int>, sjtu::leftist_heap, arena_alloc>>();
+	ok &= Exercise<sjtu::priority_queue<std::string, std::less<std::string>, sjtu::lazy_leftist_heap, arena_alloc>, std::string>();
+	ok &= Exercise<sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<4>, arena_alloc>>();
+	ok &= Exercise<sjtu::priority_queue<std::string, std::less<std::string>, sjtu::pairing_heap, arena_alloc>, std::string>();
+
+	// an allocator keeps the resource it was built with.
+	counting_resource outer;
+	sjtu::arena inner;
+	{
+		sjtu::resource_scope s(&outer);
+		sjtu::vector<long, sjtu::polymorphic_allocator<long>> v;
+		{
+			sjtu::resource_scope t(&inner);
+			ok &= sjtu::get_default_resource() == &inner;
+			for (long i = 0; i < 1000; ++i) v.push_back(i);
+		}
+		ok &= sjtu::get_default_resource() == &outer;
+		ok &= outer.calls > 0 && v.size() == 1000 && v[999] == 999;
+	}
+	ok &= sjtu::get_default_resource() == sjtu::new_delete_resource() && !outer.live;
+
+	// a buffer is used before any chunk, and alignment is honoured.
+	alignas(64) unsigned char buffer[256];
+	{
+		sjtu::arena b(buffer, sizeof(buffer));
+		void *p = b.allocate(100, 1);
+		void *q = b.allocate(8, 64);
+		void *r = b.allocate(1000, 32);
+		auto in = [&](void *x) { return (unsigned char *) x >= buffer && (unsigned char *) x < buffer + sizeof(buffer); };
+		ok &= in(p) && in(q) && !in(r);
+		ok &= (uintptr_t) q % 64 == 0 && (uintptr_t) r % 32 == 0;
+		b.release();
+		ok &= b.allocate(16) == buffer;
+	}
+	std::cout << (ok ? "ok." : "") << std::endl;
+	return 0;
+}
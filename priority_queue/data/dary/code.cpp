@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+
+#include "dary_heap.hpp"
+
+template<size_t D>
+void TestAgainstStd()
+{
+	std::cout << "Testing " << D << "-ary heap against std::priority_queue...";
+	sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<D>> pq;
+	std::priority_queue<int> ref;
+	for (int i = 0; i < 200000; ++i) {
+		int op = rand() % 3;
+		if (op < 2 || ref.empty()) {
+			int x = rand() % 1000;
+			pq.push(x);
+			ref.push(x);
+		} else {
+			pq.pop();
+			ref.pop();
+		}
+		if (pq.size() != ref.size() || (!ref.empty() && pq.top() != ref.top()))
+			return std::cout << std::endl, void();
+	}
+	decltype(pq) copy(pq), other;
+	for (int i = 0; i < 5000; ++i) other.push(rand() % 3000);
+	copy.merge(other);
+	if (!other.empty() || copy.size() != pq.size() + 5000)
+		return std::cout << std::endl, void();
+	int last = copy.top();
+	while (!copy.empty()) {
+		if (copy.top() > last) return std::cout << std::endl, void();
+		last = copy.top();
+		copy.pop();
+	}
+	try {
+		copy.pop();
+		return std::cout << std::endl, void();
+	} catch (sjtu::container_is_empty &) {
+	}
+	std::cout << "ok." << std::endl;
+}
+
+struct Natural {
+	int x;
+	Natural(int _x = 0) { x = _x; }
+	friend bool operator<(const Natural &lhs, const Natural &rhs) {
+		if (lhs.x < 0 || rhs.x < 0)
+			throw sjtu::runtime_error();
+		return lhs.x < rhs.x;
+	}
+};
+
+void TestCompareException()
+{
+	std::cout << "Testing compare exception...";
+	sjtu::priority_queue<Natural, std::less<Natural>, sjtu::dary_heap<>> pq, bad;
+	static int ans[1000];
+	int pos = 0;
+	for (int i = 1; i <= 1000; ++i) {
+		int x = rand() % 1000;
+		if (i > 1 && rand() % 10 == 0) x = -x - 1;
+		try {
+			pq.push(Natural(x));
+			ans[pos++] = x;
+		} catch (sjtu::runtime_error &) {
+			if (x >= 0) return std::cout << std::endl, void();
+		}
+	}
+	bad.push(Natural(-1));
+	try {
+		pq.merge(bad);
+		return std::cout << std::endl, void();
+	} catch (sjtu::runtime_error &) {
+	}
+	std::sort(ans, ans + pos);
+	if (bad.size() != 1 || (int) pq.size() != pos) return std::cout << std::endl, void();
+	for (int i = pos - 1; i >= 0; --i) {
+		if (pq.top().x != ans[i]) return std::cout << std::endl, void();
+		pq.pop();
+	}
+	std::cout << "ok." << std::endl;
+}
+
+// throws on the armed-th comparison from now on.
+struct Armed {
+	static int armed;
+	bool operator()(int a, int b) const {
+		if (armed > 0 && --armed == 0) throw sjtu::runtime_error();
+		return a < b;
+	}
+};
+int Armed::armed = 0;
+
+void TestMergeRollback()
+{
+	std::cout << "Testing merge rollback...";
+	using Q = sjtu::priority_queue<int, Armed, sjtu::dary_heap<>>;
+	Q pq;
+	for (int i = 0; i < 1000; ++i) pq.push(rand() % 1000);
+	// a small merge is done by pushing one by one; a throw must undo every push.
+	for (int k = 1; k < 200; ++k) {
+		Q other;
+		for (int i = 0; i < 10; ++i) other.push(rand() % 2000);
+		Q before(pq);
+		Armed::armed = k;
+		try {
+			pq.merge(other);
+			Armed::armed = 0;
+			if (pq.size() != 1010 || !other.empty()) return std::cout << std::endl, void();
+			pq = before;
+			continue;
+		} catch (sjtu::runtime_error &) {
+		}
+		if (pq.size() != 1000 || other.size() != 10) return std::cout << std::endl, void();
+		for (Q a(pq), b(before); !a.empty(); a.pop(), b.pop())
+			if (a.top() != b.top()) return std::cout << std::endl, void();
+	}
+	std::cout << "ok." << std::endl;
+}
+
+int main()
+{
+	TestAgainstStd<2>();
+	TestAgainstStd<3>();
+	TestAgainstStd<4>();
+	TestAgainstStd<8>();
+	TestCompareException();
+	TestMergeRollback();
+	return 0;
+}
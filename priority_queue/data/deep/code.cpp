@@ -0,0 +1,81 @@
+#include <iostream>
+
+#include "priority_queue.hpp"
+
+// pushing ascending keys into a max-heap puts every new root above the old
+// one as its left child, so the tree is one left spine of length n.
+void TestDeepTree()
+{
+	std::cout << "Testing copy and release of a deep tree...";
+	const int n = 2000000;
+	sjtu::priority_queue<int> pq;
+	for (int i = 1; i <= n; ++i) pq.push(i);
+	sjtu::priority_queue<int> copy(pq);
+	sjtu::priority_queue<int> assigned;
+	assigned.push(-1);
+	assigned = copy;
+	for (int i = n; i > n - 1000; --i) {
+		if (copy.top() != i || assigned.top() != i) return std::cout << std::endl, void();
+		copy.pop();
+		assigned.pop();
+	}
+	if (copy.size() != n - 1000 || assigned.size() != n - 1000 || pq.size() != n)
+		return std::cout << std::endl, void();
+	std::cout << "ok." << std::endl;
+}
+
+struct Fragile {
+	static int copies_left;
+	int x;
+	Fragile(int _x) : x(_x) {}
+	Fragile(const Fragile &other) : x(other.x) {
+		if (copies_left-- == 0) throw sjtu::runtime_error();
+	}
+	friend bool operator<(const Fragile &lhs, const Fragile &rhs) {
+		if (lhs.x < 0 || rhs.x < 0) throw sjtu::runtime_error();
+		return lhs.x < rhs.x;
+	}
+};
+int Fragile::copies_left = -1;
+
+void TestStrongGuarantee()
+{
+	std::cout << "Testing rollback of push, merge and assignment...";
+	sjtu::priority_queue<Fragile> pq, other;
+	for (int i = 0; i < 1000; ++i) pq.push(Fragile((i * 7919) % 1000));
+	bool thrown = 0;
+	try {
+		pq.push(Fragile(-1));
+	} catch (sjtu::runtime_error) {
+		thrown = 1;
+	}
+	other.push(Fragile(-2));
+	try {
+		pq.merge(other);
+		thrown = 0;
+	} catch (sjtu::runtime_error) {
+	}
+	sjtu::priority_queue<Fragile> target;
+	target.push(Fragile(5));
+	Fragile::copies_left = 500;
+	try {
+		target = pq;
+		thrown = 0;
+	} catch (sjtu::runtime_error) {
+	}
+	Fragile::copies_left = -1;
+	if (!thrown || pq.size() != 1000 || other.size() != 1 || target.size() != 1 || target.top().x != 5)
+		return std::cout << std::endl, void();
+	for (int i = 999; i >= 0; --i) {
+		if (pq.top().x != i) return std::cout << std::endl, void();
+		pq.pop();
+	}
+	std::cout << "ok." << std::endl;
+}
+
+int main()
+{
+	TestDeepTree();
+	TestStrongGuarantee();
+	return 0;
+}
@@ -8,8 +8,8 @@
 #include "priority_queue.hpp"
 
 int rand() {
-	static int reed = 1727417277;
-	return (reed += (reed << 5) + 172741827);
+	static unsigned reed = 1727417277u;
+	return (int) (reed += (reed << 5) + 172741827u);
 }
 
 bool testmerge()
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "priority_queue.hpp"
+
+using lazy_queue = sjtu::priority_queue<int, std::less<int>, sjtu::lazy_leftist_heap>;
+
+void TestRandom()
+{
+	std::cout << "Testing random operations on the lazy heap..." << std::flush;
+	lazy_queue q;
+	std::priority_queue<int> ref;
+	for (int i = 0; i < 200000; ++i) {
+		int op = rand() % 16;
+		if (op < 8) {
+			int x = rand();
+			q.push(x);
+			ref.push(x);
+		} else if (op < 12) {
+			if (q.empty() != ref.empty()) return std::cout << std::endl, void();
+			if (ref.empty()) continue;
+			if (q.top() != ref.top()) return std::cout << std::endl, void();
+			q.pop();
+			ref.pop();
+		} else if (op < 14) {
+			lazy_queue other;
+			int n = rand() % 20;
+			for (int j = 0; j < n; ++j) {
+				int x = rand();
+				other.push(x);
+				ref.push(x);
+			}
+			if (n && rand() % 2) other.top();
+			q.merge(other);
+			if (!other.empty()) return std::cout << std::endl, void();
+		} else if (op < 15) {
+			std::vector<int> v(rand() % 10);
+			for (int &x : v) x = rand(), ref.push(x);
+			q.push_range(v.begin(), v.end());
+		} else if (i % 1000 == 15) {
+			// copies and moves see the pending elements too
+			lazy_queue copy(q);
+			lazy_queue moved(std::move(copy));
+			q = moved;
+		}
+		if (q.size() != ref.size()) return std::cout << std::endl, void();
+	}
+	while (!ref.empty()) {
+		if (q.top() != ref.top()) return std::cout << std::endl, void();
+		q.pop();
+		ref.pop();
+	}
+	std::cout << (q.empty() ? "ok." : "") << std::endl;
+}
+
+void TestMergeChain()
+{
+	std::cout << "Testing merge of many lazy heaps..." << std::flush;
+	std::vector<lazy_queue> parts(1000);
+	for (int i = 0; i < 100000; ++i) parts[i % 1000].push(i);
+	for (int i = 1; i < 1000; i += 2) parts[i].top();
+	for (int i = 1; i < 1000; ++i) parts[0].merge(parts[i]);
+	for (int i = 99999; i >= 0; --i) {
+		if (parts[0].pop_value() != i) return std::cout << std::endl, void();
+	}
+	std::cout << (parts[0].empty() ? "ok." : "") << std::endl;
+}
+
+int armed = -1;
+struct Fuse {
+	int x;
+	std::string tag;
+	Fuse(int _x) : x(_x), tag(std::to_string(_x)) {}
+	// the comparison after armed more of them throws
+	friend bool operator<(const Fuse &lhs, const Fuse &rhs) {
+		if (armed >= 0 && armed-- == 0)
+			throw sjtu::runtime_error();
+		return lhs.x < rhs.x;
+	}
+};
+
+void TestException()
+{
+	std::cout << "Testing compare exception while consolidating..." << std::flush;
+	using fuse_queue = sjtu::priority_queue<Fuse, std::less<Fuse>, sjtu::lazy_leftist_heap>;
+	fuse_queue q;
+	int next = 0, thrown = 0;
+	for (int k = 0; k < 200; ++k) {
+		// push and merge compare nothing, so they cannot throw
+		armed = 0;
+		for (int i = 0; i < 20; ++i) q.push(Fuse(next++ * 7919 % 100003));
+		fuse_queue other;
+		for (int i = 0; i < 5; ++i) other.push(Fuse(next++ * 7919 % 100003));
+		q.merge(other);
+		armed = -1;
+		if (k % 3 == 0) q.top();
+		armed = k % 30;
+		try {
+			q.top();
+		} catch (sjtu::runtime_error &) {
+			++thrown;
+		}
+		armed = -1;
+		if (q.size() != (size_t) next) return std::cout << std::endl, void();
+	}
+	std::vector<int> all;
+	for (int i = 0; i < next; ++i) all.push_back(i * 7919 % 100003);
+	std::sort(all.begin(), all.end());
+	for (int i = next - 1; i >= 0; --i) {
+		Fuse f = q.pop_value();
+		if (f.x != all[i] || f.tag != std::to_string(all[i])) return std::cout << std::endl, void();
+	}
+	std::cout << (thrown > 100 ? "ok." : "") << std::endl;
+}
+
+int main()
+{
+	TestRandom();
+	TestMergeChain();
+	TestException();
+	return 0;
+}
@@ -0,0 +1,137 @@
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <string>
+
+#include "minmax_heap.hpp"
+
+void TestRandom()
+{
+	std::cout << "Testing random operations on minmax_heap...";
+	sjtu::minmax_heap<int> q;
+	std::multiset<int> ref;
+	for (int i = 0; i < 300000; ++i) {
+		int op = rand() % 8;
+		if (op < 4) {
+			int x = rand() % 5000;
+			q.push(x);
+			ref.insert(x);
+		} else if (!ref.empty()) {
+			if (q.top_min() != *ref.begin() || q.top_max() != *ref.rbegin()) return std::cout << std::endl, void();
+			if (op < 6) {
+				q.pop_min();
+				ref.erase(ref.begin());
+			} else {
+				q.pop_max();
+				ref.erase(std::prev(ref.end()));
+			}
+		}
+		if (q.size() != ref.size()) return std::cout << std::endl, void();
+	}
+	sjtu::minmax_heap<int> copy(q);
+	while (!ref.empty()) {
+		if (q.top_max() != *ref.rbegin() || copy.top_min() != *ref.begin()) return std::cout << std::endl, void();
+		q.pop_max();
+		ref.erase(std::prev(ref.end()));
+		if (!ref.empty()) {
+			copy.pop_min();
+			q.pop_min();
+			ref.erase(ref.begin());
+		}
+	}
+	std::cout << (q.empty() ? "ok." : "") << std::endl;
+}
+
+void TestSmall()
+{
+	std::cout << "Testing small minmax_heaps...";
+	for (int n = 1; n <= 40; ++n) {
+		for (int mask = 0; mask < 64; ++mask) {
+			sjtu::minmax_heap<int> q;
+			std::multiset<int> ref;
+			for (int i = 0; i < n; ++i) {
+				int x = (i * 37 + mask * 11) % (n + 3);
+				q.push(x);
+				ref.insert(x);
+			}
+			for (int i = 0; i < n; ++i) {
+				bool max = (mask >> (i % 6)) & 1;
+				int want = max ? *ref.rbegin() : *ref.begin();
+				int got = max ? q.top_max() : q.top_min();
+				if (want != got) return std::cout << std::endl, void();
+				if (max) q.pop_max(), ref.erase(std::prev(ref.end()));
+				else q.pop_min(), ref.erase(ref.begin());
+			}
+			if (!q.empty()) return std::cout << std::endl, void();
+		}
+	}
+	try {
+		sjtu::minmax_heap<int> q;
+		q.top_max();
+		return std::cout << std::endl, void();
+	} catch (sjtu::container_is_empty &) {}
+	std::cout << "ok." << std::endl;
+}
+
+int armed = -1;
+struct Fuse {
+	int x;
+	std::string tag;
+	Fuse(int _x) : x(_x), tag(std::to_string(_x)) {}
+	// the comparison after armed more of them throws
+	friend bool operator<(const Fuse &lhs, const Fuse &rhs) {
+		if (armed >= 0 && armed-- == 0)
+			throw sjtu::runtime_error();
+		return lhs.x < rhs.x;
+	}
+};
+
+void TestException()
+{
+	std::cout << "Testing compare exception in minmax_heap...";
+	sjtu::minmax_heap<Fuse> q;
+	std::multiset<int> ref;
+	for (int i = 0; i < 500; ++i) {
+		int x = i * 7919 % 1000;
+		q.push(Fuse(x));
+		ref.insert(x);
+	}
+	for (int k = 0; k < 3000; ++k) {
+		armed = k % 17;
+		try {
+			switch (k % 3) {
+				case 0: {
+					Fuse f(k * 31 % 1000);
+					q.push(std::move(f));
+					ref.insert(k * 31 % 1000);
+					break;
+				}
+				case 1:
+					q.pop_min();
+					ref.erase(ref.begin());
+					break;
+				default:
+					q.pop_max();
+					ref.erase(std::prev(ref.end()));
+			}
+		} catch (sjtu::runtime_error &) {}
+		armed = -1;
+		if (q.size() != ref.size() || q.top_min().x != *ref.begin() || q.top_max().x != *ref.rbegin())
+			return std::cout << std::endl, void();
+	}
+	while (!ref.empty()) {
+		if (q.top_min().x != *ref.begin() || q.top_min().tag != std::to_string(*ref.begin()))
+			return std::cout << std::endl, void();
+		q.pop_min();
+		ref.erase(ref.begin());
+	}
+	std::cout << "ok." << std::endl;
+}
+
+int main()
+{
+	TestRandom();
+	TestSmall();
+	TestException();
+	return 0;
+}
@@ -0,0 +1,162 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dary_heap.hpp"
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+
+struct Counted {
+	static int copies;
+	int x;
+	std::string pad;
+	Counted(int _x) : x(_x), pad(40, 'a' + _x % 26) {}
+	Counted(int _x, char c) : x(_x), pad(40, c) {}
+	Counted(const Counted &o) : x(o.x), pad(o.pad) { ++copies; }
+	Counted(Counted &&o) noexcept : x(o.x), pad(std::move(o.pad)) {}
+	Counted &operator=(const Counted &o) {
+		++copies;
+		x = o.x;
+		pad = o.pad;
+		return *this;
+	}
+	Counted &operator=(Counted &&o) noexcept {
+		x = o.x;
+		pad = std::move(o.pad);
+		return *this;
+	}
+	friend bool operator<(const Counted &lhs, const Counted &rhs) { return lhs.x < rhs.x; }
+};
+int Counted::copies = 0;
+
+template<class Q>
+void TestNoCopy(const char *name)
+{
+	std::cout << "Testing push(T&&), emplace and pop_value of " << name << "...";
+	Counted::copies = 0;
+	Q q;
+	for (int i = 0; i < 2000; ++i) {
+		int k = i * 7919 % 2003;
+		if (i & 1) q.push(Counted(k));
+		else q.emplace(k, 'a' + k % 26);
+	}
+	int last = 1 << 30;
+	while (!q.empty()) {
+		Counted c = q.pop_value();
+		if (c.x > last || c.pad != std::string(40, 'a' + c.x % 26)) return std::cout << std::endl, void();
+		last = c.x;
+	}
+	if (Counted::copies != 0) return std::cout << Counted::copies << " copies" << std::endl, void();
+	std::cout << "ok." << std::endl;
+}
+
+struct PtrLess {
+	bool operator()(const std::unique_ptr<int> &lhs, const std::unique_ptr<int> &rhs) const { return *lhs < *rhs; }
+};
+
+template<class Q>
+void TestMoveOnly(const char *name)
+{
+	std::cout << "Testing move-only elements in " << name << "...";
+	Q q;
+	for (int i = 0; i < 1000; ++i) {
+		if (i & 1) q.push(std::make_unique<int>(i * 31 % 1009));
+		else q.emplace(new int(i * 31 % 1009));
+	}
+	int last = 1 << 30;
+	for (int i = 0; i < 1000; ++i) {
+		std::unique_ptr<int> p = q.pop_value();
+		if (!p || *p > last) return std::cout << std::endl, void();
+		last = *p;
+	}
+	std::cout << (q.empty() ? "ok." : "") << std::endl;
+}
+
+struct Natural {
+	int x;
+	std::string tag;
+	Natural(int _x = 0) : x(_x), tag(std::to_string(_x)) {}
+	friend bool operator<(const Natural &lhs, const Natural &rhs) {
+		if (lhs.x < 0 || rhs.x < 0)
+			throw sjtu::runtime_error();
+		return lhs.x < rhs.x;
+	}
+};
+
+template<class Q>
+void TestException(const char *name)
+{
+	std::cout << "Testing compare exception with moves in " << name << "...";
+	Q q;
+	for (int i = 0; i < 100; ++i) q.push(Natural(i));
+	Natural bad(-1);
+	try {
+		q.push(std::move(bad));
+		return std::cout << std::endl, void();
+	} catch (sjtu::runtime_error &) {}
+	// the moved-from argument got its value back
+	if (bad.x != -1 || bad.tag != "-1") return std::cout << std::endl, void();
+	try {
+		q.emplace(-2);
+		return std::cout << std::endl, void();
+	} catch (sjtu::runtime_error &) {}
+	if (q.size() != 100) return std::cout << std::endl, void();
+	for (int i = 99; i >= 0; --i) {
+		Natural n = q.pop_value();
+		if (n.x != i || n.tag != std::to_string(i)) return std::cout << std::endl, void();
+	}
+	std::cout << "ok." << std::endl;
+}
+
+int armed = -1;
+struct Fuse {
+	int x;
+	std::string tag;
+	Fuse(int _x) : x(_x), tag(std::to_string(_x)) {}
+	// the comparison after armed more of them throws
+	friend bool operator<(const Fuse &lhs, const Fuse &rhs) {
+		if (armed >= 0 && armed-- == 0)
+			throw sjtu::runtime_error();
+		return lhs.x < rhs.x;
+	}
+};
+
+template<class Q>
+void TestPopException(const char *name)
+{
+	std::cout << "Testing compare exception in pop_value of " << name << "...";
+	Q q;
+	for (int i = 0; i < 300; ++i) q.push(Fuse(i * 37 % 300));
+	for (int k = 0; k < 5; ++k) {
+		armed = k;
+		try {
+			q.pop_value();
+			return std::cout << std::endl, void();
+		} catch (sjtu::runtime_error &) {}
+		armed = -1;
+		if (q.size() != 300 || q.top().x != 299 || q.top().tag != "299") return std::cout << std::endl, void();
+	}
+	for (int i = 299; i >= 0; --i) {
+		Fuse f = q.pop_value();
+		if (f.x != i || f.tag != std::to_string(i)) return std::cout << std::endl, void();
+	}
+	std::cout << "ok." << std::endl;
+}
+
+int main()
+{
+	TestNoCopy<sjtu::priority_queue<Counted>>("leftist_heap");
+	TestNoCopy<sjtu::priority_queue<Counted, std::less<Counted>, sjtu::dary_heap<4>>>("dary_heap");
+	TestNoCopy<sjtu::priority_queue<Counted, std::less<Counted>, sjtu::pairing_heap>>("pairing_heap");
+	TestMoveOnly<sjtu::priority_queue<std::unique_ptr<int>, PtrLess>>("leftist_heap");
+	TestMoveOnly<sjtu::priority_queue<std::unique_ptr<int>, PtrLess, sjtu::dary_heap<4>>>("dary_heap");
+	TestMoveOnly<sjtu::priority_queue<std::unique_ptr<int>, PtrLess, sjtu::pairing_heap>>("pairing_heap");
+	TestException<sjtu::priority_queue<Natural>>("leftist_heap");
+	TestException<sjtu::priority_queue<Natural, std::less<Natural>, sjtu::dary_heap<4>>>("dary_heap");
+	TestException<sjtu::priority_queue<Natural, std::less<Natural>, sjtu::pairing_heap>>("pairing_heap");
+	TestPopException<sjtu::priority_queue<Fuse>>("leftist_heap");
+	TestPopException<sjtu::priority_queue<Fuse, std::less<Fuse>, sjtu::dary_heap<4>>>("dary_heap");
+	TestPopException<sjtu::priority_queue<Fuse, std::less<Fuse>, sjtu::pairing_heap>>("pairing_heap");
+	return 0;
+}
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "dary_heap.hpp"
+#include "multi_queue.hpp"
+
+void TestSequential()
+{
+	std::cout << "Testing multi_queue with one shard...";
+	sjtu::multi_queue<int> q(1, 1);
+	std::vector<int> v(10000);
+	for (int &x : v) x = rand();
+	for (int x : v) q.push(x);
+	std::sort(v.begin(), v.end());
+	int out;
+	for (int i = (int) v.size() - 1; i >= 0; --i)
+		if (!q.try_pop(out) || out != v[i]) return std::cout << std::endl, void();
+	std::cout << (!q.try_pop(out) && q.empty() ? "ok." : "") << std::endl;
+}
+
+// rank of each popped element among those still present, via a Fenwick tree.
+void TestRankError()
+{
+	std::cout << "Testing rank error of multi_queue...";
+	const int n = 1 << 17;
+	sjtu::multi_queue<int, std::less<int>, sjtu::dary_heap<4>> q(4, 2);
+	std::vector<int> keys(n), tree(n + 1, 0);
+	for (int i = 0; i < n; ++i) keys[i] = i;
+	std::shuffle(keys.begin(), keys.end(), std::mt19937(233));
+	for (int k : keys) q.push(k);
+	auto add = [&](int i, int d) {
+		for (++i; i <= n; i += i & -i) tree[i] += d;
+	};
+	auto below = [&](int i) {
+		int s = 0;
+		for (; i > 0; i -= i & -i) s += tree[i];
+		return s;
+	};
+	for (int i = 0; i < n; ++i) add(i, 1);
+	double total = 0;
+	int worst = 0, out, present = n;
+	while (q.try_pop(out)) {
+		// elements greater than out that are still present
+		int rank = present - below(out + 1);
+		total += rank;
+		worst = std::max(worst, rank);
+		add(out, -1);
+		--present;
+	}
+	double mean = total / n;
+	int m = (int) q.shards();
+	if (present != 0 || mean > m || worst > 32 * m) return std::cout << mean << " " << worst << std::endl, void();
+	std::cout << "ok." << std::endl;
+}
+
+void TestConcurrent()
+{
+	std::cout << "Testing concurrent push and try_pop...";
+	const int threads = 4, per_thread = 50000;
+	sjtu::multi_queue<int> q(threads);
+	std::vector<std::atomic<int>> seen(threads * per_thread);
+	std::atomic<int> popped{0};
+	std::atomic<bool> wrapped{false};
+	std::vector<std::thread> pool;
+	// each thread pushes its own range and pops as much as it pushes
+	for (int t = 0; t < threads; ++t)
+		pool.emplace_back([&, t] {
+			int out;
+			for (int i = 0; i < per_thread; ++i) {
+				q.push(t * per_thread + i);
+				if (i % 2 && q.try_pop(out)) ++seen[out], ++popped;
+				// a pop counted before its push would wrap the size around.
+				if (q.size() > (size_t) threads * per_thread) wrapped = true;
+			}
+			while (q.try_pop(out)) ++seen[out], ++popped;
+		});
+	for (auto &th : pool) th.join();
+	int out;
+	while (q.try_pop(out)) ++seen[out], ++popped;
+	bool ok = popped == threads * per_thread && q.empty() && !wrapped;
+	for (auto &s : seen) ok &= s == 1;
+	std::cout << (ok ? "ok." : "") << std::endl;
+}
+
+struct Natural {
+	int x;
+	Natural(int _x = 0) { x = _x; }
+	friend bool operator<(const Natural &lhs, const Natural &rhs) {
+		if (lhs.x < 0 || rhs.x < 0)
+			throw sjtu::runtime_error();
+		return lhs.x < rhs.x;
+	}
+};
+
+void TestException()
+{
+	std::cout << "Testing compare exception in multi_queue...";
+	sjtu::multi_queue<Natural> q(1, 1);
+	for (int i = 0; i < 100; ++i) q.push(Natural(i));
+	try {
+		q.push(Natural(-1));
+		return std::cout << std::endl, void();
+	} catch (sjtu::runtime_error &) {}
+	if (q.size() != 100) return std::cout << std::endl, void();
+	Natural out;
+	for (int i = 99; i >= 0; --i)
+		if (!q.try_pop(out) || out.x != i) return std::cout << std::endl, void();
+	std::cout << "ok." << std::endl;
+}
+
+int main()
+{
+	TestSequential();
+	TestRankError();
+	TestConcurrent();
+	TestException();
+	return 0;
+}
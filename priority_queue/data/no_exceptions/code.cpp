@@ -0,0 +1,69 @@
+// built with -fno-exceptions: failed checks abort instead of throwing.
+#define SJTU_NO_EXCEPTIONS
+#include <csignal>
+#include <cstdio>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "dary_heap.hpp"
+#include "minmax_heap.hpp"
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+#include "radix_heap.hpp"
+#include "vector.hpp"
+
+// run f in a child process and report whether it aborted.
+template<class F>
+bool aborts(F f)
+{
+	fflush(stdout);
+	pid_t pid = fork();
+	if (pid == 0) {
+		freopen("/dev/null", "w", stderr);
+		f();
+		_exit(0);
+	}
+	int status = 0;
+	waitpid(pid, &status, 0);
+	return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
+
+template<class Q>
+bool drain(Q &q, int n)
+{
+	for (int i = 0; i < n; ++i) q.push(i * 7 % n);
+	for (int i = n - 1; i >= 0; --i) {
+		if (q.top() != i) return false;
+		q.pop();
+	}
+	return q.empty();
+}
+
+int main()
+{
+	sjtu::priority_queue<int> leftist;
+	sjtu::priority_queue<int, std::less<int>, sjtu::lazy_leftist_heap> lazy;
+	sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<4>> dary;
+	sjtu::priority_queue<int, std::less<int>, sjtu::pairing_heap> pairing;
+	bool ok = drain(leftist, 1000) && drain(lazy, 1000) && drain(dary, 1000) && drain(pairing, 1000);
+	sjtu::minmax_heap<int> mm;
+	sjtu::radix_heap<unsigned, int> radix;
+	for (int i = 0; i < 100; ++i) mm.push(i), radix.push(i, i);
+	ok &= mm.top_min() == 0 && mm.top_max() == 99 && radix.top().second == 0;
+	sjtu::vector<int> v;
+	v.push_back(1);
+	ok &= v.at(0) == 1;
+	printf("Test 1: containers without exceptions %s\n", ok ? "PASSED" : "FAILED");
+
+	ok = aborts([] { sjtu::priority_queue<int>().pop(); });
+	ok &= aborts([] { sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<4>>().top(); });
+	ok &= aborts([] { sjtu::vector<int>().at(3); });
+	ok &= aborts([&] {
+		radix.pop();
+		radix.pop();
+		radix.push(0, 0);
+	});
+	ok &= !aborts([] { sjtu::vector<int>().push_back(1); });
+	printf("Test 2: failed checks abort %s\n", ok ? "PASSED" : "FAILED");
+	return 0;
+}
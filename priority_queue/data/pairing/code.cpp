@@ -0,0 +1,180 @@
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "pairing_heap.hpp"
+
+using heap = sjtu::priority_queue<int, std::less<int>, sjtu::pairing_heap>;
+
+void TestAgainstMultiset()
+{
+	std::cout << "Testing push, pop, decrease_key, update and erase...";
+	heap pq;
+	std::multiset<int> ref;
+	std::vector<heap::handle> hs;
+	for (int i = 0; i < 200000; ++i) {
+		int op = rand() % 6;
+		if (op < 2 || ref.empty()) {
+			int x = rand() % 100000;
+			hs.push_back(pq.push(x));
+			ref.insert(x);
+		} else if (op == 2) {
+			ref.erase(std::prev(ref.end()));
+			for (size_t j = 0; j < hs.size(); ++j)
+				if (&*hs[j] == &pq.top()) {
+					hs[j] = hs.back();
+					hs.pop_back();
+					break;
+				}
+			pq.pop();
+		} else {
+			size_t j = rand() % hs.size();
+			heap::handle h = hs[j];
+			ref.erase(ref.find(*h));
+			if (op == 3) {
+				int x = *h + rand() % 1000 - 100;
+				pq.decrease_key(h, x);
+				ref.insert(x);
+			} else if (op == 4) {
+				*h = rand() % 100000;
+				pq.update(h);
+				ref.insert(*h);
+			} else {
+				pq.erase(h);
+				hs[j] = hs.back();
+				hs.pop_back();
+			}
+		}
+		if (pq.size() != ref.size() || (!ref.empty() && pq.top() != *ref.rbegin()))
+			return std::cout << std::endl, void();
+	}
+	heap copy(pq), other;
+	for (int i = 0; i < 1000; ++i) other.push(i);
+	copy.merge(other);
+	if (!other.empty() || copy.size() != pq.size() + 1000) return std::cout << std::endl, void();
+	int last = copy.top();
+	while (!copy.empty()) {
+		if (copy.top() > last) return std::cout << std::endl, void();
+		last = copy.top();
+		copy.pop();
+	}
+	std::cout << "ok." << std::endl;
+}
+
+// Dijkstra on a random graph without stale entries, checked against Bellman-Ford.
+void TestDijkstra()
+{
+	std::cout << "Testing Dijkstra with decrease_key...";
+	const int n = 2000, m = 20000;
+	struct edge { int to, w; };
+	std::vector<std::vector<edge>> g(n);
+	for (int i = 0; i < m; ++i) g[rand() % n].push_back({rand() % n, rand() % 100 + 1});
+	struct item {
+		long long d;
+		int v;
+		bool operator>(const item &rhs) const { return d > rhs.d; }
+	};
+	sjtu::priority_queue<item, std::greater<item>, sjtu::pairing_heap> pq;
+	std::vector<decltype(pq)::handle> at(n);
+	std::vector<long long> dist(n, -1);
+	std::vector<char> done(n);
+	dist[0] = 0;
+	at[0] = pq.push({0, 0});
+	size_t peak = 0;
+	while (!pq.empty()) {
+		peak = pq.size() > peak ? pq.size() : peak;
+		int u = pq.top().v;
+		pq.pop();
+		done[u] = 1;
+		for (edge e : g[u]) {
+			long long nd = dist[u] + e.w;
+			if (done[e.to] || (dist[e.to] != -1 && dist[e.to] <= nd)) continue;
+			if (dist[e.to] == -1) at[e.to] = pq.push({nd, e.to});
+			else pq.decrease_key(at[e.to], {nd, e.to});
+			dist[e.to] = nd;
+		}
+	}
+	std::vector<long long> ref(n, -1);
+	ref[0] = 0;
+	for (bool changed = true; changed;) {
+		changed = false;
+		for (int u = 0; u < n; ++u)
+			if (ref[u] != -1)
+				for (edge e : g[u])
+					if (ref[e.to] == -1 || ref[u] + e.w < ref[e.to]) ref[e.to] = ref[u] + e.w, changed = true;
+	}
+	if (ref != dist || peak > (size_t) n) return std::cout << std::endl, void();
+	std::cout << "ok." << std::endl;
+}
+
+struct Natural {
+	int x;
+	Natural(int _x = 0) { x = _x; }
+	friend bool operator<(const Natural &lhs, const Natural &rhs) {
+		if (lhs.x < 0 || rhs.x < 0)
+			throw sjtu::runtime_error();
+		return lhs.x < rhs.x;
+	}
+};
+
+void TestCompareException()
+{
+	std::cout << "Testing compare exception...";
+	using nheap = sjtu::priority_queue<Natural, std::less<Natural>, sjtu::pairing_heap>;
+	nheap pq;
+	std::vector<nheap::handle> hs;
+	std::multiset<int> ref;
+	for (int i = 0; i < 2000; ++i) {
+		int x = rand() % 1000;
+		hs.push_back(pq.push(Natural(x)));
+		ref.insert(x);
+	}
+	for (int i = 0; i < 500; ++i) {
+		pq.pop();
+		ref.erase(std::prev(ref.end()));
+	}
+	hs.clear();
+	for (int i = 0; i < 300; ++i) {
+		int x = rand() % 1000;
+		hs.push_back(pq.push(Natural(x)));
+		ref.insert(x);
+	}
+	int thrown = 0;
+	for (int i = 0; i < 300; ++i) {
+		try {
+			pq.push(Natural(-1));
+		} catch (sjtu::runtime_error &) {
+			++thrown;
+		}
+		try {
+			pq.decrease_key(hs[i], Natural(-1));
+		} catch (sjtu::runtime_error &) {
+			++thrown;
+		}
+		int old = hs[i]->x;
+		hs[i]->x = -1;
+		try {
+			pq.update(hs[i]);
+		} catch (sjtu::runtime_error &) {
+			++thrown;
+		}
+		hs[i]->x = old;
+	}
+	// push and decrease_key always compare with -1; update may not need to
+	if (thrown < 600 || pq.size() != ref.size()) return std::cout << std::endl, void();
+	for (auto it = ref.rbegin(); it != ref.rend(); ++it) {
+		if (pq.top().x != *it) return std::cout << std::endl, void();
+		pq.pop();
+	}
+	std::cout << "ok." << std::endl;
+}
+
+int main()
+{
+	TestAgainstMultiset();
+	TestDijkstra();
+	TestCompareException();
+	return 0;
+}
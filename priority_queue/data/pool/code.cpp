@@ -0,0 +1,72 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+
+struct Counted {
+	static int alive;
+	int x;
+	Counted(int _x) : x(_x) { ++alive; }
+	Counted(const Counted &other) : x(other.x) { ++alive; }
+	~Counted() { --alive; }
+	bool operator<(const Counted &rhs) const { return x < rhs.x; }
+};
+int Counted::alive = 0;
+
+template<class Q>
+bool Drain(Q &q, size_t expect)
+{
+	if (q.size() != expect) return false;
+	auto last = q.top();
+	for (; !q.empty(); q.pop()) {
+		if (last < q.top()) return false;
+		last = q.top();
+	}
+	return true;
+}
+
+template<class T>
+T Make(int x) { return T(x); }
+template<>
+std::string Make<std::string>(int x) { return std::to_string(x); }
+
+template<class Q, class T = int>
+bool Exercise()
+{
+	Q a;
+	for (int round = 0; round < 20; ++round) {
+		Q parts[8];
+		for (int i = 0; i < 5000; ++i) parts[rand() % 8].push(Make<T>(rand() % 10000));
+		for (Q &p : parts) a.merge(p);
+		for (int i = 0; i < 2000; ++i) a.pop();
+	}
+	Q b(a), c;
+	c = b;
+	Q d(std::move(c));
+	for (int i = 0; i < 1000; ++i) b.pop();
+	return Drain(a, 60000) && Drain(b, 59000) && Drain(d, 60000) && c.empty();
+}
+
+template<typename Type>
+using std_alloc = std::allocator<Type>;
+
+int main()
+{
+	std::cout << "Testing the node pool...";
+	bool ok = Exercise<sjtu::priority_queue<int>>();
+	ok &= Exercise<sjtu::priority_queue<int, std::less<int>, sjtu::leftist_heap, std_alloc>>();
+	ok &= Exercise<sjtu::priority_queue<std::string>, std::string>();
+	ok &= Exercise<sjtu::priority_queue<int, std::less<int>, sjtu::pairing_heap>>();
+	ok &= Exercise<sjtu::priority_queue<Counted, std::less<Counted>, sjtu::pairing_heap>, Counted>();
+	ok &= Exercise<sjtu::priority_queue<Counted>, Counted>();
+	{
+		// destroyed without popping: every destructor must still run
+		sjtu::priority_queue<Counted> q, r;
+		for (int i = 0; i < 10000; ++i) (i % 2 ? q : r).push(i);
+		q.merge(r);
+	}
+	std::cout << (ok && !Counted::alive ? "ok." : "") << std::endl;
+	return 0;
+}
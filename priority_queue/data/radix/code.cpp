@@ -0,0 +1,152 @@
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "radix_heap.hpp"
+
+template<typename Key>
+void TestMonotone(const char *name, Key spread)
+{
+	std::cout << "Testing monotone keys in radix_heap<" << name << ">...";
+	sjtu::radix_heap<Key, std::string> q;
+	std::priority_queue<Key, std::vector<Key>, std::greater<Key>> ref;
+	Key last = 0;
+	for (int i = 0; i < 300000; ++i) {
+		if (rand() % 3) {
+			Key k = last + (Key) ((unsigned long long) rand() * rand() % ((unsigned long long) spread + 1));
+			if (k < last) k = last;
+			q.push(k, std::to_string(k));
+			ref.push(k);
+		} else if (!ref.empty()) {
+			if (q.top().first != ref.top() || q.top().second != std::to_string(ref.top()))
+				return std::cout << std::endl, void();
+			last = ref.top();
+			q.pop();
+			ref.pop();
+			if (q.last() != last) return std::cout << std::endl, void();
+		}
+		if (q.size() != ref.size() || q.empty() != ref.empty()) return std::cout << std::endl, void();
+	}
+	while (!ref.empty()) {
+		if (q.top().first != ref.top()) return std::cout << std::endl, void();
+		q.pop();
+		ref.pop();
+	}
+	std::cout << (q.empty() ? "ok." : "") << std::endl;
+}
+
+void TestEdges()
+{
+	std::cout << "Testing extreme keys and errors...";
+	sjtu::radix_heap<unsigned long long, int> q;
+	try {
+		q.pop();
+		return std::cout << std::endl, void();
+	} catch (sjtu::container_is_empty &) {}
+	unsigned long long big = ~0ull;
+	q.push(big, 1);
+	q.push(0, 2);
+	q.push(big - 1, 3);
+	q.push(1ull << 63, 4);
+	if (q.top().second != 2) return std::cout << std::endl, void();
+	q.pop();
+	if (q.top().first != 1ull << 63) return std::cout << std::endl, void();
+	q.pop();
+	// below the last key popped
+	try {
+		q.push(5, 5);
+		return std::cout << std::endl, void();
+	} catch (sjtu::invalid_iterator &) {}
+	if (q.size() != 2) return std::cout << std::endl, void();
+	q.push(1ull << 63, 6);
+	sjtu::radix_heap<unsigned long long, int> copy(q);
+	int order[] = {6, 3, 1};
+	for (int v : order) {
+		if (q.top().second != v || copy.top().second != v) return std::cout << std::endl, void();
+		q.pop();
+		copy.pop();
+	}
+	std::cout << (q.empty() && copy.empty() ? "ok." : "") << std::endl;
+}
+
+// top does not pop: keys between the last one popped and the top stay allowed.
+void TestPushAfterTop()
+{
+	std::cout << "Testing push after top...";
+	sjtu::radix_heap<unsigned, int> q;
+	q.push(5u, 5);
+	q.push(10u, 10);
+	if (q.top().first != 5 || q.last() != 0) return std::cout << std::endl, void();
+	try {
+		q.push(3u, 3);
+	} catch (...) {
+		return std::cout << std::endl, void();
+	}
+	if (q.top().second != 3) return std::cout << std::endl, void();
+	q.pop();
+	if (q.last() != 3 || q.top().second != 5) return std::cout << std::endl, void();
+	// pushes under the remembered top, into lower and equal buckets, between tops.
+	std::priority_queue<unsigned, std::vector<unsigned>, std::greater<unsigned>> ref;
+	ref.push(5u);
+	ref.push(10u);
+	for (int i = 0; i < 200000; ++i) {
+		unsigned low = q.last(), top = q.empty() ? low + 1000 : q.top().first;
+		if (rand() % 4) {
+			unsigned k = low + (unsigned) rand() % (top - low + 1);
+			q.push(k, (int) k);
+			ref.push(k);
+		} else if (!ref.empty()) {
+			if (q.top().first != ref.top() || q.top().second != (int) ref.top()) return std::cout << std::endl, void();
+			q.pop();
+			ref.pop();
+		}
+		if (q.size() != ref.size()) return std::cout << std::endl, void();
+	}
+	std::cout << "ok." << std::endl;
+}
+
+// Dijkstra on a random graph, against the same run with std::priority_queue.
+void TestDijkstra()
+{
+	std::cout << "Testing Dijkstra with radix_heap...";
+	int n = 20000, m = 100000;
+	std::vector<std::vector<std::pair<int, unsigned>>> g(n);
+	for (int i = 0; i < m; ++i) g[rand() % n].push_back({rand() % n, (unsigned) (rand() % 1000)});
+	std::vector<unsigned> d1(n, ~0u), d2(n, ~0u);
+	sjtu::radix_heap<unsigned, int> q;
+	d1[0] = 0;
+	q.push(0u, 0);
+	while (!q.empty()) {
+		auto [du, u] = std::pair<unsigned, int>(q.top().first, q.top().second);
+		q.pop();
+		if (du != d1[u]) continue;
+		for (auto [v, w] : g[u])
+			if (du + w < d1[v]) q.push(d1[v] = du + w, v);
+	}
+	std::priority_queue<std::pair<unsigned, int>, std::vector<std::pair<unsigned, int>>, std::greater<>> ref;
+	d2[0] = 0;
+	ref.push({0u, 0});
+	while (!ref.empty()) {
+		auto [du, u] = ref.top();
+		ref.pop();
+		if (du != d2[u]) continue;
+		for (auto [v, w] : g[u])
+			if (du + w < d2[v]) ref.push({d2[v] = du + w, v});
+	}
+	std::cout << (d1 == d2 ? "ok." : "") << std::endl;
+}
+
+int main()
+{
+	TestMonotone<unsigned char>("unsigned char", 10);
+	TestMonotone<unsigned>("unsigned", 1000);
+	TestMonotone<unsigned long long>("unsigned long long", 1ull << 40);
+	TestEdges();
+	TestPushAfterTop();
+	TestDijkstra();
+	return 0;
+}
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <vector>
+
+#include "dary_heap.hpp"
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+
+template<class Q>
+void TestBuild(const char *name)
+{
+	std::cout << "Testing range construction of " << name << "...";
+	std::vector<int> all;
+	for (int n : {0, 1, 2, 3, 7, 64, 1000, 100000}) {
+		std::vector<int> v(n);
+		for (int &x : v) x = rand() % 1000;
+		std::list<int> more(rand() % 50);
+		for (int &x : more) x = rand() % 1000;
+		Q q(v.begin(), v.end());
+		q.push_range(more.begin(), more.end());
+		q.push_range(more.begin(), more.begin());
+		v.insert(v.end(), more.begin(), more.end());
+		std::sort(v.begin(), v.end());
+		if (q.size() != v.size()) return std::cout << std::endl, void();
+		for (int i = (int) v.size() - 1; i >= 0; --i) {
+			if (q.top() != v[i]) return std::cout << std::endl, void();
+			q.pop();
+		}
+	}
+	std::cout << "ok." << std::endl;
+}
+
+struct Natural {
+	int x;
+	Natural(int _x = 0) { x = _x; }
+	friend bool operator<(const Natural &lhs, const Natural &rhs) {
+		if (lhs.x < 0 || rhs.x < 0)
+			throw sjtu::runtime_error();
+		return lhs.x < rhs.x;
+	}
+};
+
+template<class Q>
+void TestException(const char *name)
+{
+	std::cout << "Testing compare exception in push_range of " << name << "...";
+	std::vector<Natural> good, bad;
+	for (int i = 0; i < 1000; ++i) good.push_back(Natural(i));
+	for (int i = 0; i < 1000; ++i) bad.push_back(Natural(i == 777 ? -1 : i));
+	Q q(good.begin(), good.end());
+	int thrown = 0;
+	try {
+		q.push_range(bad.begin(), bad.end());
+	} catch (sjtu::runtime_error &) {
+		++thrown;
+	}
+	try {
+		Q r(bad.begin(), bad.end());
+	} catch (sjtu::runtime_error &) {
+		++thrown;
+	}
+	if (thrown != 2 || q.size() != 1000) return std::cout << std::endl, void();
+	for (int i = 999; i >= 0; --i) {
+		if (q.top().x != i) return std::cout << std::endl, void();
+		q.pop();
+	}
+	std::cout << "ok." << std::endl;
+}
+
+template<typename Type>
+using std_alloc = std::allocator<Type>;
+
+int main()
+{
+	TestBuild<sjtu::priority_queue<int>>("leftist_heap");
+	TestBuild<sjtu::priority_queue<int, std::less<int>, sjtu::leftist_heap, std_alloc>>("leftist_heap with std::allocator");
+	TestBuild<sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<>>>("dary_heap");
+	TestBuild<sjtu::priority_queue<int, std::less<int>, sjtu::pairing_heap>>("pairing_heap");
+	TestException<sjtu::priority_queue<Natural>>("leftist_heap");
+	TestException<sjtu::priority_queue<Natural, std::less<Natural>, sjtu::leftist_heap, std_alloc>>("leftist_heap with std::allocator");
+	TestException<sjtu::priority_queue<Natural, std::less<Natural>, sjtu::dary_heap<>>>("dary_heap");
+	TestException<sjtu::priority_queue<Natural, std::less<Natural>, sjtu::pairing_heap>>("pairing_heap");
+	return 0;
+}
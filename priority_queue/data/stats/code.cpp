@@ -0,0 +1,44 @@
+#define SJTU_STATS
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "priority_queue.hpp"
+#include "vector.hpp"
+
+using sjtu::stats_registry;
+
+int main()
+{
+	std::cout << "Testing the stats...";
+	bool ok = true;
+
+	// capacities 2, 4, ..., 1024: nine buffers replaced, 2 + 4 + ... + 512 elements moved.
+	sjtu::vector<int> v;
+	for (int i = 0; i < 1024; ++i) v.push_back(i);
+	ok &= v.stats().reallocations == 9 && v.stats().bytes_moved == 1022 * sizeof(int);
+	ok &= stats_registry::value("vector.reallocations") == 9;
+	ok &= stats_registry::value("vector.bytes_moved") == 1022 * sizeof(int);
+
+	// a leftist merge passes both right spines, at most log2(n + 1) nodes each.
+	const int n = 100000;
+	sjtu::priority_queue<int> a, b;
+	for (int i = 0; i < n; ++i) (i % 2 ? a : b).push(rand());
+	ok &= a.stats().merges == n / 2 && b.stats().merges == n / 2;
+	ok &= a.stats().longest_path <= 2 * std::log2(n + 1);
+	a.merge(b);
+	for (int i = 0; i < n / 2; ++i) a.pop();
+	// the pushes, the merge of b, then one merge per pop.
+	ok &= a.stats().merges == n / 2 + 1 + n / 2;
+	ok &= a.stats().merge_steps > a.stats().merges && a.stats().longest_path <= 2 * std::log2(n + 1);
+
+	size_t merges = a.stats().merges + b.stats().merges;
+	size_t steps = a.stats().merge_steps + b.stats().merge_steps;
+	size_t path = a.stats().longest_path > b.stats().longest_path ? a.stats().longest_path : b.stats().longest_path;
+	ok &= stats_registry::value("priority_queue.merges") == merges;
+	ok &= stats_registry::value("priority_queue.merge_steps") == steps;
+	ok &= stats_registry::value("priority_queue.merge_path") == path;
+
+	std::cout << (ok ? "ok." : "") << std::endl;
+	return 0;
+}
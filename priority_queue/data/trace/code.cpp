@@ -0,0 +1,44 @@
+#include <cstdio>
+
+#include "dary_heap.hpp"
+#include "recorded_queue.hpp"
+#include <unistd.h>
+
+using sjtu::trace_reader;
+
+template<class Policy>
+bool check(const char *path)
+{
+	bool ok = true;
+	{
+		sjtu::recorded_queue<int, std::less<int>, Policy> q(path);
+		q.push(3);
+		q.push(-1);
+		q.emplace(5);
+		sjtu::priority_queue<int, std::less<int>, Policy> other;
+		other.push(4);
+		other.push(9);
+		q.merge(other);
+		ok &= q.top() == 9 && q.size() == 5;
+		q.pop();
+	}
+	trace_reader t(path);
+	ok &= t.ok() && t.kind() == sjtu::trace_kind::priority_queue && t.size() == 6;
+	const uint64_t *r = t.records();
+	ok &= r[0] == sjtu::trace_key(3) && r[1] == sjtu::trace_key(-1) && r[2] == sjtu::trace_key(5);
+	ok &= trace_reader::key(r[1]) < trace_reader::key(r[0]);
+	ok &= r[3] == (uint64_t(sjtu::trace_merge) << 60 | 2);
+	ok &= trace_reader::op(r[4]) == sjtu::trace_top && trace_reader::op(r[5]) == sjtu::trace_pop;
+	ok &= r[4] << 4 == sjtu::trace_key(9) << 4 && r[5] << 4 == r[4] << 4;
+	unlink(path);
+	return ok;
+}
+
+int main()
+{
+	bool ok = check<sjtu::leftist_heap>("queue-trace.bin");
+	ok &= check<sjtu::lazy_leftist_heap>("queue-trace.bin");
+	ok &= check<sjtu::dary_heap<4>>("queue-trace.bin");
+	puts(ok ? "ok" : "failed");
+	return 0;
+}
@@ -0,0 +1,268 @@
+#ifndef SJTU_DARY_HEAP_HPP
+#define SJTU_DARY_HEAP_HPP
+
+#include "exceptions.hpp"
+#include "priority_queue.hpp"
+#include "vector.hpp"
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace sjtu {
+
+/**
+ * priority_queue over an implicit D-ary heap in one sjtu::vector: no
+ * allocation per push or pop once the vector has grown, and each level is
+ * a scan of D adjacent elements instead of a pointer chase.
+ *
+ * push and pop first find where the moved element ends up using only
+ * comparisons, and move elements only once that is known, so a throwing
+ * Compare leaves the queue unchanged. merge and push_range have no
+ * better bound than rebuilding: they copy both sides into a new array and
+ * heapify it in O(n + m), unless pushing the m new elements one by one
+ * is cheaper.
+ *
+ * The move operations of T must not throw.
+ */
+template<typename T, class Compare, size_t D, template<typename Type> class Alloc>
+class priority_queue<T, Compare, dary_heap<D>, Alloc> {
+	static_assert(D >= 2, "a heap needs at least two children per node");
+	using storage = vector<T, Alloc<T>>;
+
+public:
+	priority_queue() = default;
+	priority_queue(const priority_queue &other) = default;
+	priority_queue(priority_queue &&other) noexcept = default;
+	template<class ForwardIt>
+	priority_queue(ForwardIt first, ForwardIt last) { push_range(first, last); }
+	priority_queue &operator=(const priority_queue &other) {
+		if (this == &other) return *this;
+		storage tmp{other._heap};
+		_heap = std::move(tmp);
+		return *this;
+	}
+	priority_queue &operator=(priority_queue &&other) = default;
+
+	const T &top() const {
+		if (_heap.empty()) SJTU_THROW(container_is_empty);
+		return _heap[0];
+	}
+
+	void push(const T &e) { emplace(e); }
+	// if Compare throws, e gets its value back.
+	void push(T &&e) {
+		_heap.push_back(std::move(e));
+		size_t pos;
+		SJTU_TRY {
+			pos = sift_up_target(_heap.size() - 1);
+		} SJTU_CATCH_ALL {
+			e = std::move(_heap[_heap.size() - 1]);
+			_heap.pop_back();
+			SJTU_RETHROW;
+		}
+		sift_up(pos);
+	}
+	template<class... Args>
+	void emplace(Args &&...args) {
+		_heap.emplace_back(std::forward<Args>(args)...);
+		size_t pos;
+		SJTU_TRY {
+			pos = sift_up_target(_heap.size() - 1);
+		} SJTU_CATCH_ALL {
+			_heap.pop_back();
+			SJTU_RETHROW;
+		}
+		sift_up(pos);
+	}
+
+	/**
+	 * O(min(size() + n, n log size())): a few elements are pushed one by
+	 * one, many by heapifying everything again. Unchanged if anything
+	 * throws.
+	 */
+	template<class ForwardIt>
+	void push_range(ForwardIt first, ForwardIt last) {
+		size_t n = std::distance(first, last), old = _heap.size();
+		if (n * std::bit_width(old + n) < old + n) {
+			push_each(first, last);
+			return;
+		}
+		storage all{_heap};
+		for (; first != last; ++first) all.push_back(*first);
+		heapify(all);
+		_heap = std::move(all);
+	}
+
+	void pop() {
+		if (_heap.empty()) SJTU_THROW(container_is_empty);
+		size_t last = _heap.size() - 1;
+		if (last) {
+			size_t path[max_depth];
+			int len = sift_down_path(0, last, path);
+			sift_down(path, len, last);
+		}
+		_heap.pop_back();
+	}
+
+	// pop and return the top element, moved out rather than copied.
+	T pop_value() {
+		if (_heap.empty()) SJTU_THROW(container_is_empty);
+		size_t last = _heap.size() - 1;
+		size_t path[max_depth];
+		int len = last ? sift_down_path(0, last, path) : 0;
+		T ret(std::move(_heap[0]));
+		if (last) sift_down(path, len, last);
+		_heap.pop_back();
+		return ret;
+	}
+
+	size_t size() const { return _heap.size(); }
+	bool empty() const { return _heap.empty(); }
+
+	void merge(priority_queue &other) {
+		if (this == &other || other.empty()) return;
+		const T *h = &other._heap[0];
+		push_range(h, h + other._heap.size());
+		other._heap.clear();
+	}
+
+private:
+	// a D-ary heap of n <= 2^64 elements is at most 64 levels deep.
+	static constexpr int max_depth = 64;
+
+	storage _heap;
+	[[no_unique_address]] Compare _opt;
+
+private:
+	// the slot the element at i would rise to; only compares.
+	size_t sift_up_target(size_t i) const {
+		const T *h = &_heap[0];
+		const T &value = h[i];
+		while (i) {
+			size_t fa = (i - 1) / D;
+			if (!_opt(h[fa], value)) break;
+			i = fa;
+		}
+		return i;
+	}
+
+	/**
+	 * push [first, last) one by one. The slot each element rose to is kept,
+	 * so that if a copy or a comparison throws, the pushes already done can
+	 * be undone in reverse order.
+	 */
+	template<class ForwardIt>
+	void push_each(ForwardIt first, ForwardIt last) {
+		size_t old = _heap.size();
+		vector<size_t> targets;
+		SJTU_TRY {
+			for (; first != last; ++first) {
+				_heap.push_back(*first);
+				size_t pos = sift_up_target(_heap.size() - 1);
+				targets.push_back(pos);
+				sift_up(pos);
+			}
+		} SJTU_CATCH_ALL {
+			if (_heap.size() > old + targets.size()) _heap.pop_back();
+			for (size_t k = targets.size(); k-- > 0;) {
+				unsift_up(old + k, targets[k]);
+				_heap.pop_back();
+			}
+			SJTU_RETHROW;
+		}
+	}
+
+	// move the element at the back up to pos; no comparisons.
+	void sift_up(size_t pos) {
+		T *h = &_heap[0];
+		size_t i = _heap.size() - 1;
+		if (i == pos) return;
+		T value = std::move(h[i]);
+		while (i != pos) {
+			size_t fa = (i - 1) / D;
+			h[i] = std::move(h[fa]);
+			i = fa;
+		}
+		h[pos] = std::move(value);
+	}
+
+	// undo sift_up(pos) of the element that was at i, the back.
+	void unsift_up(size_t i, size_t pos) {
+		if (i == pos) return;
+		size_t path[max_depth];
+		int len = 0;
+		for (size_t j = i; j != pos; j = (j - 1) / D) path[len++] = j;
+		T *h = &_heap[0];
+		T value = std::move(h[pos]);
+		size_t hole = pos;
+		while (len--) {
+			h[hole] = std::move(h[path[len]]);
+			hole = path[len];
+		}
+		h[hole] = std::move(value);
+	}
+
+	/**
+	 * the children that move up one level when h[last] is sifted down from
+	 * i within h[0, last), in order; returns how many there are. Only
+	 * compares.
+	 */
+	int sift_down_path(size_t i, size_t last, size_t *path) const {
+		const T *h = &_heap[0];
+		const T &value = h[last];
+		int len = 0;
+		while (i * D + 1 < last) {
+			size_t first = i * D + 1, end = first + D < last ? first + D : last;
+			size_t best = first;
+			for (size_t c = first + 1; c < end; ++c)
+				if (_opt(h[best], h[c])) best = c;
+			if (!_opt(value, h[best])) break;
+			path[len++] = best;
+			i = best;
+		}
+		return len;
+	}
+
+	// carry out a path from sift_down_path, filling the root's slot.
+	void sift_down(const size_t *path, int len, size_t last) {
+		T *h = &_heap[0];
+		size_t i = 0;
+		for (int k = 0; k < len; ++k) {
+			h[i] = std::move(h[path[k]]);
+			i = path[k];
+		}
+		h[i] = std::move(h[last]);
+	}
+
+	// Floyd's bottom-up heapify in O(n); a is discarded if Compare throws.
+	void heapify(storage &a) const {
+		size_t n = a.size();
+		if (n < 2) return;
+		T *h = &a[0];
+		for (size_t i = (n - 2) / D + 1; i-- > 0;) {
+			T value = std::move(h[i]);
+			size_t cur = i;
+			while (cur * D + 1 < n) {
+				size_t first = cur * D + 1, end = first + D < n ? first + D : n;
+				size_t best = first;
+				SJTU_TRY {
+					for (size_t c = first + 1; c < end; ++c)
+						if (_opt(h[best], h[c])) best = c;
+					if (!_opt(value, h[best])) break;
+				} SJTU_CATCH_ALL {
+					h[cur] = std::move(value);
+					SJTU_RETHROW;
+				}
+				h[cur] = std::move(h[best]);
+				cur = best;
+			}
+			h[cur] = std::move(value);
+		}
+	}
+};
+
+}// namespace sjtu
+
+#endif
@@ -0,0 +1,205 @@
+#ifndef SJTU_MINMAX_HEAP_HPP
+#define SJTU_MINMAX_HEAP_HPP
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace sjtu {
+
+/**
+ * a double-ended priority queue: a min-max heap (Atkinson et al. 1986) in
+ * one sjtu::vector. Levels alternate between min levels, whose elements
+ * are the smallest of their subtree, and max levels, the largest; the root
+ * is on a min level. top_min and top_max are O(1), push, pop_min and
+ * pop_max O(log n).
+ *
+ * As in the other heaps, push and the pops decide every move with
+ * comparisons first and move elements only afterwards, so a throwing
+ * Compare leaves the heap unchanged. The move operations of T must not
+ * throw.
+ */
+template<typename T, class Compare = std::less<T>, class Alloc = std::allocator<T>>
+class minmax_heap {
+	using storage = vector<T, Alloc>;
+
+public:
+	minmax_heap() = default;
+	minmax_heap(const minmax_heap &other) = default;
+	minmax_heap(minmax_heap &&other) noexcept = default;
+	minmax_heap &operator=(const minmax_heap &other) {
+		if (this == &other) return *this;
+		storage tmp{other._heap};
+		_heap = std::move(tmp);
+		return *this;
+	}
+	minmax_heap &operator=(minmax_heap &&other) = default;
+
+	const T &top_min() const {
+		if (_heap.empty()) SJTU_THROW(container_is_empty);
+		return _heap[0];
+	}
+	const T &top_max() const {
+		if (_heap.empty()) SJTU_THROW(container_is_empty);
+		return _heap[max_index()];
+	}
+
+	void push(const T &e) { emplace(e); }
+	// if Compare throws, e gets its value back.
+	void push(T &&e) {
+		_heap.push_back(std::move(e));
+		size_t path[max_depth];
+		int len;
+		SJTU_TRY {
+			len = plan_up(path);
+		} SJTU_CATCH_ALL {
+			e = std::move(_heap[_heap.size() - 1]);
+			_heap.pop_back();
+			SJTU_RETHROW;
+		}
+		move_up(path, len);
+	}
+	template<class... Args>
+	void emplace(Args &&...args) {
+		_heap.emplace_back(std::forward<Args>(args)...);
+		size_t path[max_depth];
+		int len;
+		SJTU_TRY {
+			len = plan_up(path);
+		} SJTU_CATCH_ALL {
+			_heap.pop_back();
+			SJTU_RETHROW;
+		}
+		move_up(path, len);
+	}
+
+	void pop_min() {
+		if (_heap.empty()) SJTU_THROW(container_is_empty);
+		remove<false>(0);
+	}
+	void pop_max() {
+		if (_heap.empty()) SJTU_THROW(container_is_empty);
+		remove<true>(max_index());
+	}
+
+	size_t size() const { return _heap.size(); }
+	bool empty() const { return _heap.empty(); }
+
+private:
+	// one entry per level moved through; a heap of 2^64 elements has 64 levels.
+	static constexpr int max_depth = 64;
+
+	storage _heap;
+	[[no_unique_address]] Compare _opt;
+
+private:
+	static bool on_max_level(size_t i) { return std::bit_width(i + 1) % 2 == 0; }
+
+	// whether a belongs nearer the root than b on a max (or a min) level.
+	template<bool Max>
+	bool before(const T &a, const T &b) const { return Max ? _opt(b, a) : _opt(a, b); }
+
+	size_t max_index() const {
+		size_t n = _heap.size();
+		if (n < 3) return n - 1;
+		return before<true>(_heap[2], _heap[1]) ? 2 : 1;
+	}
+
+	/**
+	 * the slots the new last element passes on its way up, in order: maybe
+	 * its parent, if it belongs on the other kind of level, then
+	 * grandparents on levels of that kind. Only compares.
+	 */
+	int plan_up(size_t *path) const {
+		const T *h = &_heap[0];
+		size_t i = _heap.size() - 1;
+		const T &value = h[i];
+		if (!i) return 0;
+		int len = 0;
+		bool max_level = on_max_level(i);
+		size_t fa = (i - 1) / 2;
+		if (max_level ? before<false>(value, h[fa]) : before<true>(value, h[fa])) {
+			path[len++] = i = fa;
+			max_level = !max_level;
+		}
+		while (i > 2) {
+			size_t grand = ((i - 1) / 2 - 1) / 2;
+			if (!(max_level ? before<true>(value, h[grand]) : before<false>(value, h[grand]))) break;
+			path[len++] = i = grand;
+		}
+		return len;
+	}
+	void move_up(const size_t *path, int len) {
+		if (!len) return;
+		T *h = &_heap[0];
+		size_t hole = _heap.size() - 1;
+		T value = std::move(h[hole]);
+		for (int k = 0; k < len; ++k) {
+			h[hole] = std::move(h[path[k]]);
+			hole = path[k];
+		}
+		h[hole] = std::move(value);
+	}
+
+	/**
+	 * the moves that fill the hole at r, on a max (or min) level, with the
+	 * last element x. steps[k] is the slot moved up at step k; bit k of
+	 * swaps says that x is then exchanged with the parent of steps[k],
+	 * because x belongs on that parent's level. Only compares: every
+	 * element compared is still in its original slot.
+	 */
+	template<bool Max>
+	int plan_down(size_t r, size_t *steps, unsigned long long &swaps) const {
+		const T *h = &_heap[0];
+		size_t n = _heap.size() - 1;
+		const T *x = &h[n];
+		int len = 0;
+		swaps = 0;
+		for (size_t i = r; 2 * i + 1 < n;) {
+			size_t best = 2 * i + 1;
+			if (best + 1 < n && before<Max>(h[best + 1], h[best])) best = best + 1;
+			bool grand = false;
+			for (size_t g = 4 * i + 3; g < 4 * i + 7 && g < n; ++g)
+				if (before<Max>(h[g], h[best])) best = g, grand = true;
+			if (!before<Max>(h[best], *x)) break;
+			steps[len] = best;
+			if (!grand) return len + 1;
+			size_t fa = (best - 1) / 2;
+			if (before<!Max>(*x, h[fa])) {
+				swaps |= 1ull << len;
+				x = &h[fa];
+			}
+			++len;
+			i = best;
+		}
+		return len;
+	}
+
+	template<bool Max>
+	void remove(size_t r) {
+		size_t last = _heap.size() - 1;
+		if (r != last) {
+			size_t steps[max_depth];
+			unsigned long long swaps;
+			int len = plan_down<Max>(r, steps, swaps);
+			T *h = &_heap[0];
+			T carried = std::move(h[last]);
+			size_t hole = r;
+			for (int k = 0; k < len; ++k) {
+				h[hole] = std::move(h[steps[k]]);
+				if (swaps >> k & 1) std::swap(carried, h[(steps[k] - 1) / 2]);
+				hole = steps[k];
+			}
+			h[hole] = std::move(carried);
+		}
+		_heap.pop_back();
+	}
+};
+
+}// namespace sjtu
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef SJTU_MULTI_QUEUE_HPP
+#define SJTU_MULTI_QUEUE_HPP
+
+#include "exceptions.hpp"
+#include "priority_queue.hpp"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <utility>
+
+namespace sjtu {
+
+/**
+ * a relaxed concurrent priority queue (MultiQueue, Rihani, Sanders &
+ * Dementiev 2015): c * P shards, each a priority_queue under a try-lock,
+ * for P threads.
+ *
+ * push locks a random shard, moving on to another if it is taken. try_pop
+ * locks two random shards and pops the better of their tops. No thread
+ * ever waits for a lock held by another, except in the final sweep of a
+ * try_pop that keeps missing.
+ *
+ * The order is relaxed: with m shards, the element popped has expected
+ * rank O(m) among the elements present, and rank O(m log m) with high
+ * probability (Alistarh et al. 2017). It is the best element when m is 1.
+ *
+ * Shards are taken from Policy, so include dary_heap.hpp or
+ * pairing_heap.hpp for those. If Compare throws, the operation fails with
+ * the queue unchanged, as with priority_queue.
+ */
+template<typename T,
+		 class Compare = std::less<T>,
+		 class Policy = leftist_heap>
+class multi_queue {
+public:
+	using queue_type = priority_queue<T, Compare, Policy>;
+
+	explicit multi_queue(size_t threads = std::thread::hardware_concurrency(), size_t c = 2)
+		: _count(threads * c != 0 ? threads * c : 1), _shards(new shard[_count]) {}
+	multi_queue(const multi_queue &) = delete;
+	multi_queue &operator=(const multi_queue &) = delete;
+	~multi_queue() { delete[] _shards; }
+
+	void push(const T &e) { emplace(e); }
+	void push(T &&e) { emplace(std::move(e)); }
+	template<class... Args>
+	void emplace(Args &&...args) {
+		for (;;) {
+			shard &s = _shards[pick()];
+			if (!s.try_lock()) continue;
+			unlocker u{s};
+			s.heap.emplace(std::forward<Args>(args)...);
+			// counted under the lock, so a pop of this element cannot come first.
+			_size.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	/**
+	 * pop an element close to the top into out. false means every shard
+	 * was seen empty, though not necessarily at the same moment.
+	 */
+	bool try_pop(T &out) {
+		for (size_t attempt = 0; attempt < 2 * _count; ++attempt) {
+			// a hint only: the sweep below decides whether the queue is empty.
+			if (!_size.load(std::memory_order_relaxed)) break;
+			size_t i = pick(), j = pick();
+			shard &a = _shards[i];
+			if (!a.try_lock()) continue;
+			unlocker ua{a};
+			shard *best = a.heap.empty() ? nullptr : &a;
+			if (i != j) {
+				shard &b = _shards[j];
+				if (!b.try_lock()) continue;
+				unlocker ub{b};
+				if (!b.heap.empty() && (!best || _opt(best->heap.top(), b.heap.top()))) best = &b;
+				if (best) return take(*best, out);
+			} else if (best) {
+				return take(*best, out);
+			}
+		}
+		// the queue is almost empty or heavily contended: take anything.
+		for (size_t i = 0; i < _count; ++i) {
+			shard &s = _shards[i];
+			s.lock();
+			unlocker u{s};
+			if (!s.heap.empty()) return take(s, out);
+		}
+		return false;
+	}
+
+	// exact when no operation is in progress.
+	size_t size() const { return _size.load(std::memory_order_relaxed); }
+	bool empty() const { return !size(); }
+	size_t shards() const { return _count; }
+
+private:
+	struct alignas(64) shard {
+		std::atomic<bool> busy{false};
+		queue_type heap;
+
+		bool try_lock() {
+			return !busy.load(std::memory_order_relaxed) && !busy.exchange(true, std::memory_order_acquire);
+		}
+		void lock() {
+			while (!try_lock()) std::this_thread::yield();
+		}
+		void unlock() { busy.store(false, std::memory_order_release); }
+	};
+	struct unlocker {
+		shard &s;
+		~unlocker() { s.unlock(); }
+	};
+
+	size_t _count;
+	shard *_shards;
+	std::atomic<size_t> _size{0};
+	[[no_unique_address]] Compare _opt;
+
+private:
+	bool take(shard &s, T &out) {
+		out = s.heap.pop_value();
+		_size.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// a uniform shard index from a per-thread xorshift generator.
+	size_t pick() const {
+		thread_local unsigned long long seed =
+				std::hash<std::thread::id>{}(std::this_thread::get_id()) * 0x9e3779b97f4a7c15ull | 1;
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		return (size_t) ((seed >> 32) * _count >> 32);
+	}
+};
+
+}// namespace sjtu
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef SJTU_NODE_POOL_HPP
+#define SJTU_NODE_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace sjtu {
+
+/**
+ * an allocator for single objects carved out of slabs, with a free list.
+ * Each container owns its own pool: copying a pool gives an empty one,
+ * moving it takes the slabs along. Requests for more than one object go to
+ * std::allocator.
+ *
+ * Besides the allocator interface it offers
+ *  - allocate_bulk(n): n adjacent objects in a slab of their own, each of
+ *    which is deallocated on its own later;
+ *  - splice(other): take over all of other's slabs in O(1), so that the
+ *    objects other handed out may be deallocated here;
+ *  - release(): free every slab at once, without deallocating the objects
+ *    one by one. Objects still alive must not need their destructors run.
+ */
+template<typename Type>
+class node_pool {
+public:
+	using value_type = Type;
+
+	node_pool() = default;
+	node_pool(const node_pool &) : node_pool() {}
+	node_pool(node_pool &&other) noexcept { take(other); }
+	node_pool &operator=(const node_pool &) = delete;
+	node_pool &operator=(node_pool &&other) noexcept {
+		if (this == &other) return *this;
+		release();
+		take(other);
+		return *this;
+	}
+	~node_pool() { release(); }
+
+	Type *allocate(size_t n) {
+		if (n != 1) return std::allocator<Type>{}.allocate(n);
+		cell *c = _free;
+		if (c) {
+			_free = c->next;
+			if (!_free) _free_tail = nullptr;
+		} else {
+			if (_bump == _bump_end) grow();
+			c = _bump++;
+		}
+		return reinterpret_cast<Type *>(c);
+	}
+	void deallocate(Type *p, size_t n) {
+		if (n != 1) return std::allocator<Type>{}.deallocate(p, n);
+		cell *c = reinterpret_cast<cell *>(p);
+		c->next = _free;
+		if (!_free) _free_tail = c;
+		_free = c;
+	}
+
+	Type *allocate_bulk(size_t n) {
+		static_assert(sizeof(cell) == sizeof(Type), "cells must be laid out like an array of Type");
+		return reinterpret_cast<Type *>(new_slab(n));
+	}
+
+	void splice(node_pool &other) noexcept {
+		if (this == &other || !other._slabs) return;
+		other._slabs_tail->next = _slabs;
+		_slabs = other._slabs;
+		if (!_slabs_tail) _slabs_tail = other._slabs_tail;
+		if (other._free) {
+			other._free_tail->next = _free;
+			if (!_free) _free_tail = other._free_tail;
+			_free = other._free;
+		}
+		// the unused tail of other's newest slab is given up until release.
+		other._slabs = other._slabs_tail = nullptr;
+		other._free = other._free_tail = nullptr;
+		other._bump = other._bump_end = nullptr;
+		other._next_count = first_count;
+	}
+
+	void release() noexcept {
+		while (_slabs) {
+			slab *nx = _slabs->next;
+			::operator delete(static_cast<void *>(_slabs), std::align_val_t{slab_align});
+			_slabs = nx;
+		}
+		_slabs_tail = nullptr;
+		_free = _free_tail = nullptr;
+		_bump = _bump_end = nullptr;
+		_next_count = first_count;
+	}
+
+	bool operator==(const node_pool &rhs) const { return this == &rhs; }
+	bool operator!=(const node_pool &rhs) const { return this != &rhs; }
+
+private:
+	union cell {
+		cell *next;
+		alignas(Type) unsigned char storage[sizeof(Type)];
+	};
+	struct slab {
+		slab *next;
+	};
+	static constexpr size_t slab_align = alignof(cell) > alignof(slab) ? alignof(cell) : alignof(slab);
+	static constexpr size_t header = (sizeof(slab) + alignof(cell) - 1) / alignof(cell) * alignof(cell);
+	// slabs double from first_count cells up to max_count.
+	static constexpr size_t first_count = 32, max_count = 4096;
+
+	slab *_slabs = nullptr, *_slabs_tail = nullptr;
+	cell *_free = nullptr, *_free_tail = nullptr;
+	cell *_bump = nullptr, *_bump_end = nullptr;
+	size_t _next_count = first_count;
+
+	cell *new_slab(size_t count) {
+		void *mem = ::operator new(header + sizeof(cell) * count, std::align_val_t{slab_align});
+		slab *s = static_cast<slab *>(mem);
+		s->next = _slabs;
+		_slabs = s;
+		if (!_slabs_tail) _slabs_tail = s;
+		return reinterpret_cast<cell *>(static_cast<char *>(mem) + header);
+	}
+	void grow() {
+		_bump = new_slab(_next_count);
+		_bump_end = _bump + _next_count;
+		if (_next_count < max_count) _next_count *= 2;
+	}
+
+	void take(node_pool &other) noexcept {
+		_slabs = other._slabs;
+		_slabs_tail = other._slabs_tail;
+		_free = other._free;
+		_free_tail = other._free_tail;
+		_bump = other._bump;
+		_bump_end = other._bump_end;
+		_next_count = other._next_count;
+		other._slabs = other._slabs_tail = nullptr;
+		other._free = other._free_tail = nullptr;
+		other._bump = other._bump_end = nullptr;
+		other._next_count = first_count;
+	}
+};
+
+}// namespace sjtu
+
+#endif
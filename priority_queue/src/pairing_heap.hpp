@@ -0,0 +1,450 @@
+#ifndef SJTU_PAIRING_HEAP_HPP
+#define SJTU_PAIRING_HEAP_HPP
+
+#include "exceptions.hpp"
+#include "priority_queue.hpp"
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+
+/**
+ * priority_queue as a pairing heap with handles.
+ *
+ * push returns a handle to the new element, which stays valid until that
+ * element is popped or erased. Through it an element can be moved towards
+ * the top (decrease_key, O(1) work), changed arbitrarily (update), or
+ * erased, without pushing duplicates.
+ *
+ * push and merge are O(1); pop and erase are O(log n) amortised, using the
+ * standard two-pass pairing of the children of the removed node.
+ *
+ * Every operation decides all of its comparisons before it relinks
+ * anything (the outcomes of a two-pass pairing are kept in the nodes), so
+ * a throwing Compare leaves the queue unchanged.
+ */
+template<typename T, class Compare, template<typename Type> class Alloc>
+class priority_queue<T, Compare, pairing_heap, Alloc> {
+private:
+	struct Node {
+		template<class... Args>
+		Node(Args &&...args) : data(std::forward<Args>(args)...) {}
+		// prev is the previous sibling, or the parent for a first child.
+		Node *child = nullptr, *next = nullptr, *prev = nullptr;
+		// scratch for planning a two-pass pairing: whether this node beat
+		// the next sibling, and whether this pair's winner beat everything to its right.
+		bool wins_pair, wins_rest;
+		T data;
+	};
+
+public:
+	class handle {
+		friend class priority_queue;
+		explicit handle(Node *n) : _node(n) {}
+
+	public:
+		handle() = default;
+		// changing the element through a handle must be followed by update(handle).
+		T &operator*() const { return _node->data; }
+		T *operator->() const { return &_node->data; }
+		bool operator==(const handle &rhs) const { return _node == rhs._node; }
+		bool operator!=(const handle &rhs) const { return _node != rhs._node; }
+
+	private:
+		Node *_node = nullptr;
+	};
+
+	priority_queue() : _rt(nullptr), _size(0) {}
+	priority_queue(const priority_queue &other) : _rt(nullptr), _size(0), _alloc(other._alloc) {
+		if (other._rt) _rt = copy_tree(other._rt);
+		_size = other._size;
+	}
+	priority_queue(priority_queue &&other) noexcept
+		: _rt(other._rt), _size(other._size), _alloc(std::move(other._alloc)) {
+		other._rt = nullptr;
+		other._size = 0;
+	}
+	template<class ForwardIt>
+	priority_queue(ForwardIt first, ForwardIt last) : _rt(nullptr), _size(0) { push_range(first, last); }
+	~priority_queue() { clear_nodes(); }
+	priority_queue &operator=(const priority_queue &other) {
+		if (this == &other) return *this;
+		priority_queue tmp{other};
+		std::swap(_rt, tmp._rt);
+		std::swap(_size, tmp._size);
+		std::swap(_alloc, tmp._alloc);
+		return *this;
+	}
+	priority_queue &operator=(priority_queue &&other) noexcept {
+		if (this == &other) return *this;
+		clear_nodes();
+		_rt = other._rt;
+		_size = other._size;
+		_alloc = std::move(other._alloc);
+		other._rt = nullptr;
+		other._size = 0;
+		return *this;
+	}
+
+	const T &top() const {
+		if (!_rt) SJTU_THROW(container_is_empty);
+		return _rt->data;
+	}
+
+	handle push(const T &e) { return emplace(e); }
+	// if Compare throws, e gets its value back.
+	handle push(T &&e) {
+		Node *np = create_node(std::move(e));
+		SJTU_TRY {
+			_rt = meld(_rt, np);
+		} SJTU_CATCH_ALL {
+			e = std::move(np->data);
+			destroy_node(np);
+			SJTU_RETHROW;
+		}
+		++_size;
+		return handle{np};
+	}
+	template<class... Args>
+	handle emplace(Args &&...args) {
+		Node *np = create_node(std::forward<Args>(args)...);
+		SJTU_TRY {
+			_rt = meld(_rt, np);
+		} SJTU_CATCH_ALL {
+			destroy_node(np);
+			SJTU_RETHROW;
+		}
+		++_size;
+		return handle{np};
+	}
+
+	// O(n): the new elements are melded into a heap of their own first, so
+	// the queue is unchanged if anything throws.
+	template<class ForwardIt>
+	void push_range(ForwardIt first, ForwardIt last) {
+		Node *sub = nullptr;
+		size_t n = 0;
+		SJTU_TRY {
+			for (; first != last; ++first, ++n) {
+				Node *np = create_node(*first);
+				SJTU_TRY {
+					sub = meld(sub, np);
+				} SJTU_CATCH_ALL {
+					destroy_node(np);
+					SJTU_RETHROW;
+				}
+			}
+			_rt = meld(_rt, sub);
+		} SJTU_CATCH_ALL {
+			release_tree(sub);
+			SJTU_RETHROW;
+		}
+		_size += n;
+	}
+
+	void pop() {
+		if (!_rt) SJTU_THROW(container_is_empty);
+		Node *old = _rt;
+		_rt = old->child ? combine(old->child) : nullptr;
+		destroy_node(old);
+		--_size;
+	}
+
+	// pop and return the top element, moved out (copied if its move may throw).
+	T pop_value() {
+		if (!_rt) SJTU_THROW(container_is_empty);
+		Node *old = _rt;
+		if (old->child) plan(old->child);
+		T ret(std::move_if_noexcept(old->data));
+		_rt = old->child ? execute(old->child) : nullptr;
+		if (_rt) _rt->prev = _rt->next = nullptr;
+		destroy_node(old);
+		--_size;
+		return ret;
+	}
+
+	/**
+	 * set *h to value, which must not rank below the current one; it is
+	 * cut from its parent and melded with the root. A value that ranks
+	 * lower is handled as update does.
+	 */
+	void decrease_key(handle h, const T &value) {
+		Node *n = checked(h);
+		if (_opt(value, n->data)) return reposition(n, &value);
+		if (n == _rt) {
+			n->data = value;
+			return;
+		}
+		bool above = _opt(_rt->data, value);
+		n->data = value;
+		cut(n);
+		if (above) {
+			link(n, _rt);
+			_rt = n;
+		} else {
+			link(_rt, n);
+		}
+	}
+
+	// restore the heap order after *h was changed in place.
+	void update(handle h) { reposition(checked(h), nullptr); }
+
+	void erase(handle h) {
+		Node *n = checked(h);
+		if (n == _rt) return pop();
+		// n's children rank below the root, so only their pairing compares.
+		if (n->child) plan(n->child);
+		cut(n);
+		if (n->child) {
+			Node *sub = execute(n->child);
+			sub->prev = sub->next = nullptr;
+			link(_rt, sub);
+		}
+		destroy_node(n);
+		--_size;
+	}
+
+	size_t size() const { return _size; }
+	bool empty() const { return !_rt; }
+
+	void merge(priority_queue &other) {
+		if (this == &other) return;
+		_rt = meld(_rt, other._rt);
+		if constexpr (splices) _alloc.splice(other._alloc);
+		other._rt = nullptr;
+		_size += other._size;
+		other._size = 0;
+	}
+
+private:
+	Node *_rt;
+	size_t _size;
+	[[no_unique_address]] Compare _opt;
+	[[no_unique_address]] Alloc<Node> _alloc;
+
+private:
+	static constexpr bool splices = requires(Alloc<Node> &a) { a.splice(a); };
+	static constexpr bool bulk_release = std::is_trivially_destructible_v<T> && requires(Alloc<Node> &a) { a.release(); };
+
+	template<class... Args>
+	Node *create_node(Args &&...args) {
+		Node *p = _alloc.allocate(1);
+		SJTU_TRY {
+			new (p) Node(std::forward<Args>(args)...);
+		} SJTU_CATCH_ALL {
+			_alloc.deallocate(p, 1);
+			SJTU_RETHROW;
+		}
+		return p;
+	}
+	void destroy_node(Node *p) {
+		p->~Node();
+		_alloc.deallocate(p, 1);
+	}
+	void clear_nodes() {
+		if constexpr (bulk_release) _alloc.release();
+		else release_tree(_rt);
+		_rt = nullptr;
+	}
+
+	static Node *checked(handle h) {
+		if (!h._node) SJTU_THROW(invalid_iterator);
+		return h._node;
+	}
+
+	// make child the first child of parent; both are roots.
+	static void link(Node *parent, Node *child) {
+		child->next = parent->child;
+		if (parent->child) parent->child->prev = child;
+		child->prev = parent;
+		parent->child = child;
+	}
+
+	// detach the subtree of a non-root node.
+	static void cut(Node *n) {
+		if (n->prev->child == n) n->prev->child = n->next;
+		else n->prev->next = n->next;
+		if (n->next) n->next->prev = n->prev;
+		n->next = n->prev = nullptr;
+	}
+
+	Node *meld(Node *a, Node *b) {
+		if (!a || !b) return a ? a : b;
+		if (_opt(a->data, b->data)) std::swap(a, b);
+		link(a, b);
+		return a;
+	}
+
+	/**
+	 * the root two-pass pairing would produce from the sibling list starting
+	 * at first: pair neighbours left to right, then fold the winners right
+	 * to left. Only compares, and records every outcome in the nodes for
+	 * execute.
+	 */
+	Node *plan(Node *first) {
+		Node *last = first;
+		for (Node *a = first;;) {
+			Node *b = a->next;
+			if (b) a->wins_pair = !_opt(a->data, b->data);
+			last = a;
+			if (!b || !b->next) break;
+			a = b->next;
+		}
+		Node *acc = pair_winner(last);
+		for (Node *a = last; a != first;) {
+			a = a->prev->prev;
+			Node *w = pair_winner(a);
+			w->wins_rest = !_opt(w->data, acc->data);
+			if (w->wins_rest) acc = w;
+		}
+		return acc;
+	}
+	static Node *pair_winner(Node *a) {
+		return a->next && !a->wins_pair ? a->next : a;
+	}
+
+	// carry out the pairing planned for the list at first; no comparisons.
+	static Node *execute(Node *first) {
+		// pass one leaves the pair roots in a list linked through next, last pair first.
+		Node *roots = nullptr;
+		for (Node *a = first; a;) {
+			Node *b = a->next, *rest = b ? b->next : nullptr;
+			Node *w = a;
+			a->next = a->prev = nullptr;
+			if (b) {
+				b->next = b->prev = nullptr;
+				if (a->wins_pair) {
+					link(a, b);
+				} else {
+					link(b, a);
+					w = b;
+				}
+			}
+			w->next = roots;
+			roots = w;
+			a = rest;
+		}
+		Node *acc = roots, *r = roots->next;
+		acc->next = nullptr;
+		while (r) {
+			Node *nx = r->next;
+			r->next = nullptr;
+			if (r->wins_rest) {
+				link(r, acc);
+				acc = r;
+			} else {
+				link(acc, r);
+			}
+			r = nx;
+		}
+		return acc;
+	}
+
+	Node *combine(Node *first) {
+		plan(first);
+		Node *r = execute(first);
+		r->prev = r->next = nullptr;
+		return r;
+	}
+
+	/**
+	 * move n to where it belongs, after assigning *value to it if given:
+	 * the rest of the heap, n alone, and n's children paired up are melded
+	 * again. Everything is compared before n is assigned or relinked.
+	 */
+	void reposition(Node *n, const T *value) {
+		const T &v = value ? *value : n->data;
+		Node *rest = n == _rt ? nullptr : _rt;
+		Node *sub = n->child ? plan(n->child) : nullptr;
+		// the winners of rest vs n, then of that vs sub
+		bool n_first = !rest || !_opt(v, rest->data);
+		const T &top_v = n_first ? v : rest->data;
+		bool sub_first = sub && _opt(top_v, sub->data);
+		if (value) n->data = *value;
+		if (rest) cut(n);
+		if (sub) sub = execute(n->child);
+		n->child = nullptr;
+		Node *r = n;
+		if (rest) {
+			if (n_first) {
+				link(n, rest);
+			} else {
+				link(rest, n);
+				r = rest;
+			}
+		}
+		if (sub) {
+			sub->prev = sub->next = nullptr;
+			if (sub_first) {
+				link(sub, r);
+				r = sub;
+			} else {
+				link(r, sub);
+			}
+		}
+		_rt = r;
+	}
+
+	// rotate first children up until there is none, then free and go to the sibling.
+	void release_tree(Node *a) {
+		while (a) {
+			if (Node *c = a->child) {
+				a->child = c->next;
+				c->next = a;
+				a = c;
+			} else {
+				Node *nx = a->next;
+				destroy_node(a);
+				a = nx;
+			}
+		}
+	}
+
+	// preorder copy with an explicit stack; the partial copy is released if anything throws.
+	Node *copy_tree(const Node *a) {
+		struct frame {
+			const Node *from;
+			Node *to;
+		};
+		Node *root = create_node(a->data);
+		size_t cap = 64, top = 0;
+		frame *stack = nullptr;
+		SJTU_TRY {
+			stack = new frame[cap];
+			stack[top++] = {a, root};
+			while (top) {
+				frame f = stack[--top];
+				if (top + 2 > cap) {
+					frame *bigger = new frame[cap * 2];
+					for (size_t i = 0; i < top; ++i) bigger[i] = stack[i];
+					delete[] stack;
+					stack = bigger;
+					cap *= 2;
+				}
+				if (f.from->next) {
+					f.to->next = create_node(f.from->next->data);
+					f.to->next->prev = f.to;
+					stack[top++] = {f.from->next, f.to->next};
+				}
+				if (f.from->child) {
+					f.to->child = create_node(f.from->child->data);
+					f.to->child->prev = f.to;
+					stack[top++] = {f.from->child, f.to->child};
+				}
+			}
+		} SJTU_CATCH_ALL {
+			delete[] stack;
+			release_tree(root);
+			SJTU_RETHROW;
+		}
+		delete[] stack;
+		return root;
+	}
+};
+
+}// namespace sjtu
+
+#endif
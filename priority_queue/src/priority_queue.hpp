@@ -2,118 +2,510 @@
 #define SJTU_PRIORITY_QUEUE_HPP
 
 #include "exceptions.hpp"
+#include "node_pool.hpp"
+#include "stats.hpp"
 #include <cstddef>
 #include <functional>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace sjtu {
 
-template<typename T, class Compare = std::less<T>>
+// storage policies for priority_queue; the leftist ones are implemented
+// here, the others in dary_heap.hpp and pairing_heap.hpp.
+struct leftist_heap {};
+struct lazy_leftist_heap {};
+template<size_t D = 4>
+struct dary_heap {};
+struct pairing_heap {};
+
+#ifdef SJTU_STATS
+// process-wide totals of priority_queue::stats().
+namespace counters {
+inline stat_counter pq_merges{"priority_queue.merges"};
+inline stat_counter pq_merge_steps{"priority_queue.merge_steps"};
+inline stat_counter pq_merge_path{"priority_queue.merge_path", stat_counter::max};
+}// namespace counters
+#endif
+
+/**
+ * a max-heap with respect to Compare. The default policy is a leftist
+ * tree, which merges in O(log n).
+ *
+ * lazy_leftist_heap is the same tree, but push and merge only append to a
+ * pending list in O(1) without comparing anything; the list is merged in
+ * by the next top or pop, pairwise like the range constructor. push is
+ * O(1) amortised and pop O(log n) amortised, see lazy_analysis.md. As top
+ * may restructure the heap, concurrent calls to it need a lock.
+ *
+ * Nodes come from Alloc<Node>, by default a node_pool owned by the queue.
+ * With a pool, merge takes over the other queue's slabs, and a queue of
+ * trivially destructible T is destroyed by freeing its slabs rather than
+ * node by node. Other allocators must be interchangeable between queues,
+ * e.g. polymorphic_allocator (arena.hpp) on one resource.
+ */
+template<typename T,
+		 class Compare = std::less<T>,
+		 class Policy = leftist_heap,
+		 template<typename Type> class Alloc = node_pool>
 class priority_queue {
+	static_assert(std::is_same_v<Policy, leftist_heap> || std::is_same_v<Policy, lazy_leftist_heap>,
+				  "the other policies need dary_heap.hpp or pairing_heap.hpp");
+	static constexpr bool lazy = std::is_same_v<Policy, lazy_leftist_heap>;
+
 private:
 	struct Node {
-		Node(T const &_data) : data(_data) {}
+		template<class... Args>
+		Node(Args &&...args) : data(std::forward<Args>(args)...) {}
 		Node *left = nullptr, *right = nullptr;
-		size_t dis = 1;
+		// a root on the pending list links the next one here instead; its
+		// dis is recomputed from the right child when it is taken off.
+		union {
+			size_t dis = 1;
+			Node *next;
+		};
 		T data;
 	};
 
 public:
 	priority_queue() : _rt(nullptr), _size(0) {}
-	priority_queue(const priority_queue &other) {
+	priority_queue(const priority_queue &other) : _rt(nullptr), _size(0), _alloc(other._alloc) {
+		other.consolidate();
 		if (other._rt) _rt = copy_tree(other._rt);
 		_size = other._size;
 	}
 
-	priority_queue(priority_queue &&other) noexcept : _rt(other._rt), _size(other._size) {
+	priority_queue(priority_queue &&other) noexcept
+		: _rt(other._rt), _size(other._size), _pending(other._pending), _pending_tail(other._pending_tail),
+		  _alloc(std::move(other._alloc)) {
 		other._rt = nullptr;
 		other._size = 0;
+		other._pending = other._pending_tail = nullptr;
 	}
-	~priority_queue() {
-		if (_rt) release_tree(_rt);
+	// O(n): see build.
+	template<class ForwardIt>
+	priority_queue(ForwardIt first, ForwardIt last) : _rt(nullptr), _size(0) {
+		size_t n = std::distance(first, last);
+		_rt = build(first, n);
+		_size = n;
 	}
+	~priority_queue() { clear_nodes(); }
 	priority_queue &operator=(const priority_queue &other) {
 		if (this == &other) return *this;
-		this->~priority_queue();
-		new (this) priority_queue{other};
+		priority_queue tmp{other};
+		std::swap(_rt, tmp._rt);
+		std::swap(_size, tmp._size);
+		std::swap(_pending, tmp._pending);
+		std::swap(_pending_tail, tmp._pending_tail);
+		std::swap(_alloc, tmp._alloc);
 		return *this;
 	}
 
-	priority_queue &&operator=(priority_queue &&other) {
+	priority_queue &operator=(priority_queue &&other) noexcept {
 		if (this == &other) return *this;
-		this->~priority_queue();
-		new (this) priority_queue{std::move(other)};
+		clear_nodes();
+		_rt = other._rt;
+		_size = other._size;
+		_pending = other._pending;
+		_pending_tail = other._pending_tail;
+		_alloc = std::move(other._alloc);
+		other._rt = nullptr;
+		other._size = 0;
+		other._pending = other._pending_tail = nullptr;
 		return *this;
 	}
 
 	const T &top() const {
-		if (!_rt) throw container_is_empty{};
+		if (!_size) SJTU_THROW(container_is_empty);
+		consolidate();
 		return _rt->data;
 	}
-	/**
-	 * TODO
-	 * push new element to the priority queue.
-	 */
-	void push(const T &e) {
-		Node *np = new Node{e};
-		try {
+	void push(const T &e) { emplace(e); }
+	// if Compare throws, e gets its value back.
+	void push(T &&e) {
+		Node *np = create_node(std::move(e));
+		if constexpr (lazy) {
+			pend(np);
+			++_size;
+			return;
+		}
+		SJTU_TRY {
+			_rt = merge_tree(_rt, np);
+		} SJTU_CATCH_ALL {
+			e = std::move(np->data);
+			destroy_node(np);
+			SJTU_RETHROW;
+		}
+		++_size;
+	}
+	template<class... Args>
+	void emplace(Args &&...args) {
+		Node *np = create_node(std::forward<Args>(args)...);
+		if constexpr (lazy) {
+			pend(np);
+			++_size;
+			return;
+		}
+		SJTU_TRY {
 			_rt = merge_tree(_rt, np);
-		} catch (...) {
-			delete np;
-			throw;
+		} SJTU_CATCH_ALL {
+			destroy_node(np);
+			SJTU_RETHROW;
 		}
 		++_size;
 	}
 
+	// O(n + log size()); the queue is unchanged if anything throws.
+	template<class ForwardIt>
+	void push_range(ForwardIt first, ForwardIt last) {
+		size_t n = std::distance(first, last);
+		Node *sub = build(first, n);
+		if constexpr (lazy) {
+			if (sub) pend(sub);
+			_size += n;
+			return;
+		}
+		SJTU_TRY {
+			_rt = merge_tree(_rt, sub);
+		} SJTU_CATCH_ALL {
+			release_tree(sub);
+			SJTU_RETHROW;
+		}
+		_size += n;
+	}
+
 	void pop() {
-		if (!_rt) throw container_is_empty{};
+		if (!_size) SJTU_THROW(container_is_empty);
+		consolidate();
 		Node *old = _rt;
 		_rt = merge_tree(_rt->left, _rt->right);
 		--_size;
-		delete old;
+		destroy_node(old);
+	}
+
+	/**
+	 * pop and return the top element, moved out rather than copied (copied
+	 * if its move constructor may throw). If Compare throws, the element is
+	 * moved back and the queue is unchanged.
+	 */
+	T pop_value() {
+		if (!_size) SJTU_THROW(container_is_empty);
+		consolidate();
+		Node *old = _rt;
+		T ret(std::move_if_noexcept(old->data));
+		SJTU_TRY {
+			_rt = merge_tree(old->left, old->right);
+		} SJTU_CATCH_ALL {
+			if constexpr (std::is_nothrow_move_constructible_v<T>) old->data = std::move(ret);
+			SJTU_RETHROW;
+		}
+		--_size;
+		destroy_node(old);
+		return ret;
 	}
 
 	size_t size() const {
 		return _size;
 	}
 	bool empty() const {
-		return !_rt;
+		return !_size;
 	}
 	void merge(priority_queue &other) {
 		if (this == &other) return;
-		_rt = merge_tree(_rt, other._rt);
+		if constexpr (lazy) {
+			if (other._rt) pend(other._rt);
+			if (other._pending) {
+				if (_pending_tail) _pending_tail->next = other._pending;
+				else _pending = other._pending;
+				_pending_tail = other._pending_tail;
+			}
+			other._pending = other._pending_tail = nullptr;
+		} else {
+			_rt = merge_tree(_rt, other._rt);
+		}
+		if constexpr (splices) _alloc.splice(other._alloc);
 		other._rt = nullptr;
 		_size += other._size;
 		other._size = 0;
 	}
 
+	// the merges of two trees this queue did; pushes and pops merge too.
+#ifdef SJTU_STATS
+	struct stats_type {
+		size_t merges = 0;
+		size_t merge_steps = 0; // nodes passed on the right spines, over all merges
+		size_t longest_path = 0;// most nodes passed in one merge
+	};
+	const stats_type &stats() const { return _stats; }
+#else
+	struct stats_type {};
+#endif
+
 private:
+	static constexpr bool splices = requires(Alloc<Node> &a) { a.splice(a); };
+	static constexpr bool bulk_allocate = requires(Alloc<Node> &a) { a.allocate_bulk(size_t{}); };
+	static constexpr bool bulk_release = std::is_trivially_destructible_v<T> && requires(Alloc<Node> &a) { a.release(); };
+
+	template<class... Args>
+	Node *create_node(Args &&...args) {
+		Node *p = _alloc.allocate(1);
+		SJTU_TRY {
+			new (p) Node(std::forward<Args>(args)...);
+		} SJTU_CATCH_ALL {
+			_alloc.deallocate(p, 1);
+			SJTU_RETHROW;
+		}
+		return p;
+	}
+	void destroy_node(Node *p) {
+		p->~Node();
+		_alloc.deallocate(p, 1);
+	}
+
+	void clear_nodes() {
+		if constexpr (bulk_release) {
+			_alloc.release();
+		} else {
+			release_tree(_rt);
+			while (_pending) {
+				Node *nx = _pending->next;
+				release_tree(_pending);
+				_pending = nx;
+			}
+		}
+		_rt = nullptr;
+		_pending = _pending_tail = nullptr;
+	}
+
+	// append the root t to the pending list.
+	void pend(Node *t) const {
+		t->next = nullptr;
+		if (_pending_tail) _pending_tail->next = t;
+		else _pending = t;
+		_pending_tail = t;
+	}
+
+	/**
+	 * merge the pending list into _rt. Single nodes are merged pairwise as
+	 * in build, O(k) for k of them; whole trees (from merge and push_range)
+	 * are merged into the result one at a time, O(log n) each. If Compare
+	 * throws, the trees not yet merged go back on the pending list, so the
+	 * queue still holds the same elements.
+	 */
+	void consolidate() const {
+		if (!lazy || !_pending) return;
+		Node *stack[64];
+		int rank[64], depth = 0;
+		Node *p = _pending, *tail = _pending_tail, *t = nullptr, *acc = _rt;
+		SJTU_TRY {
+			while (p) {
+				t = p;
+				p = p->next;
+				t->dis = t->right ? t->right->dis + 1 : 1;
+				if (t->left) {
+					acc = merge_tree(acc, t);
+					t = nullptr;
+					continue;
+				}
+				int r = 0;
+				while (depth && rank[depth - 1] == r) {
+					Node *u = merge_tree(stack[depth - 1], t);
+					--depth;
+					t = u;
+					++r;
+				}
+				stack[depth] = t;
+				rank[depth++] = r;
+				t = nullptr;
+			}
+			if (depth) {
+				t = stack[--depth];
+				while (depth) {
+					Node *u = merge_tree(stack[depth - 1], t);
+					--depth;
+					t = u;
+				}
+				acc = merge_tree(acc, t);
+				t = nullptr;
+			}
+		} SJTU_CATCH_ALL {
+			_rt = acc;
+			_pending = p;
+			_pending_tail = p ? tail : nullptr;
+			if (t) pend(t);
+			while (depth) pend(stack[--depth]);
+			SJTU_RETHROW;
+		}
+		_rt = acc;
+		_pending = _pending_tail = nullptr;
+	}
+
+	/**
+	 * a leftist tree of the n elements from first, in O(n) by pairwise
+	 * merging: the pairs a FIFO queue of singletons would merge, taken
+	 * depth first like a binary counter, so each merge works on nodes
+	 * made moments ago. A tree of 2^r elements costs O(r) to merge and
+	 * there are n / 2^r of them, which sums to O(n). The nodes take one
+	 * contiguous block when Alloc can provide it. If anything throws,
+	 * every node made so far is freed.
+	 */
+	template<class ForwardIt>
+	Node *build(ForwardIt first, size_t n) {
+		if (!n) return nullptr;
+		// stack[d] holds 2^rank[d] elements; ranks strictly decrease upwards.
+		Node *stack[64];
+		int rank[64], depth = 0;
+		Node *t = nullptr, *block = nullptr;
+		size_t made = 0;
+		SJTU_TRY {
+			if constexpr (bulk_allocate) block = _alloc.allocate_bulk(n);
+			for (; made < n; ++first) {
+				if constexpr (bulk_allocate) {
+					t = new (block + made) Node(*first);
+				} else {
+					t = create_node(*first);
+				}
+				++made;
+				int r = 0;
+				while (depth && rank[depth - 1] == r) {
+					Node *u = merge_tree(stack[depth - 1], t);
+					--depth;
+					t = u;
+					++r;
+				}
+				stack[depth] = t;
+				rank[depth++] = r;
+				t = nullptr;
+			}
+			t = stack[--depth];
+			while (depth) {
+				Node *u = merge_tree(stack[depth - 1], t);
+				--depth;
+				t = u;
+			}
+		} SJTU_CATCH_ALL {
+			release_tree(t);
+			while (depth) release_tree(stack[--depth]);
+			if (block)
+				for (size_t k = made; k < n; ++k) _alloc.deallocate(block + k, 1);
+			SJTU_RETHROW;
+		}
+		return t;
+	}
+
+	// rotate left children up until there is none, then free and go right: no stack needed.
 	void release_tree(Node *a) {
-		if (a->left) release_tree(a->left);
-		if (a->right) release_tree(a->right);
-		delete a;
+		while (a) {
+			if (Node *l = a->left) {
+				a->left = l->right;
+				l->right = a;
+				a = l;
+			} else {
+				Node *r = a->right;
+				destroy_node(a);
+				a = r;
+			}
+		}
 	}
 
-	Node *copy_tree(Node *a) {
-		Node *p = new Node{*a};
-		if (a->left) p->left = copy_tree(a->left);
-		if (a->right) p->right = copy_tree(a->right);
-		return p;
+	/**
+	 * preorder copy with an explicit stack of (source, copy) pairs.
+	 * Children are linked as soon as they are made, so if a copy of T or an
+	 * allocation throws, the partial tree is released and nothing leaks.
+	 */
+	Node *copy_tree(const Node *a) {
+		struct frame {
+			const Node *from;
+			Node *to;
+		};
+		Node *root = create_node(a->data);
+		root->dis = a->dis;
+		size_t cap = 64, top = 0;
+		frame *stack = nullptr;
+		SJTU_TRY {
+			stack = new frame[cap];
+			stack[top++] = {a, root};
+			while (top) {
+				frame f = stack[--top];
+				if (top + 2 > cap) {
+					frame *bigger = new frame[cap * 2];
+					for (size_t i = 0; i < top; ++i) bigger[i] = stack[i];
+					delete[] stack;
+					stack = bigger;
+					cap *= 2;
+				}
+				if (f.from->right) {
+					f.to->right = create_node(f.from->right->data);
+					f.to->right->dis = f.from->right->dis;
+					stack[top++] = {f.from->right, f.to->right};
+				}
+				if (f.from->left) {
+					f.to->left = create_node(f.from->left->data);
+					f.to->left->dis = f.from->left->dis;
+					stack[top++] = {f.from->left, f.to->left};
+				}
+			}
+		} SJTU_CATCH_ALL {
+			delete[] stack;
+			release_tree(root);
+			SJTU_RETHROW;
+		}
+		delete[] stack;
+		return root;
 	}
 
-	Node *merge_tree(Node *a, Node *b) {
+	Node *merge_tree(Node *a, Node *b) const {
+		size_t before = merge_steps();
+		Node *ret = merge_spines(a, b);
+		count_merge(before);
+		return ret;
+	}
+	/**
+	 * recursion only follows the two right spines, each at most
+	 * log2(n + 1) long, so the depth is bounded. Every link is written on
+	 * the way back up, after all comparisons are done: a throwing Compare
+	 * leaves both heaps untouched.
+	 */
+	Node *merge_spines(Node *a, Node *b) const {
 		if (a == nullptr || b == nullptr)
 			return a == nullptr ? b : a;
+		count_merge_step();
 		if (_opt(a->data, b->data)) std::swap(a, b);
-		a->right = merge_tree(a->right, b);
+		a->right = merge_spines(a->right, b);
 		if (!a->left || a->right->dis > a->left->dis) std::swap(a->left, a->right);
 		a->dis = a->right ? a->right->dis + 1 : 1;
 		return a;
 	}
 
 private:
-	Node *_rt;
+	mutable Node *_rt;
 	size_t _size;
+	// lazy_leftist_heap only: roots waiting to be merged in, linked through next.
+	mutable Node *_pending = nullptr, *_pending_tail = nullptr;
 	[[no_unique_address]] Compare _opt;
+	[[no_unique_address]] Alloc<Node> _alloc;
+	[[no_unique_address]] mutable stats_type _stats;
+
+private:
+	// instrumentation, see stats.hpp; these do nothing without SJTU_STATS.
+#ifdef SJTU_STATS
+	size_t merge_steps() const { return _stats.merge_steps; }
+	void count_merge_step() const { ++_stats.merge_steps; }
+	void count_merge(size_t before) const {
+		size_t path = _stats.merge_steps - before;
+		++_stats.merges;
+		if (path > _stats.longest_path) _stats.longest_path = path;
+		counters::pq_merges.add(1);
+		counters::pq_merge_steps.add(path);
+		counters::pq_merge_path.add(path);
+	}
+#else
+	size_t merge_steps() const { return 0; }
+	void count_merge_step() const {}
+	void count_merge(size_t) const {}
+#endif
 };
 
 }// namespace sjtu
@@ -0,0 +1,146 @@
+#ifndef SJTU_RADIX_HEAP_HPP
+#define SJTU_RADIX_HEAP_HPP
+
+#include "exceptions.hpp"
+#include "utility.hpp"
+#include "vector.hpp"
+#include <bit>
+#include <climits>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+
+/**
+ * a min-heap of (key, value) pairs for unsigned integer keys that never
+ * go below the last key popped, e.g. timestamps or Dijkstra distances.
+ *
+ * An element sits in bucket bit_width(key ^ last), where last is the
+ * last key popped: bucket 0 holds the keys equal to last, and every key
+ * in bucket i is smaller than every key in bucket i + 1. push is O(1).
+ * When bucket 0 runs empty, the first non-empty bucket is emptied into
+ * the lower ones with its minimum as the new last; an element only ever
+ * moves down, so pop is O(log C) amortised, C being the largest
+ * difference between a key and last.
+ *
+ * push throws invalid_iterator for a key below last. top moves nothing
+ * and leaves last alone: when bucket 0 is empty it scans the first
+ * non-empty bucket for the minimum and remembers where it is until the
+ * next pop, so concurrent calls to it need a lock. The move operations of
+ * Key and Value must not throw.
+ */
+template<typename Key, typename Value>
+class radix_heap {
+	static_assert(std::is_integral_v<Key> && std::is_unsigned_v<Key>, "radix_heap needs unsigned integer keys");
+
+public:
+	using value_type = pair<Key, Value>;
+
+	radix_heap() = default;
+
+	// the element with the smallest key.
+	const value_type &top() const {
+		if (!_size) SJTU_THROW(container_is_empty);
+		if (!_buckets[0].empty()) return _buckets[0][_buckets[0].size() - 1];
+		if (_min_bucket < 0) find_min();
+		return _buckets[_min_bucket][_min_index];
+	}
+	void push(Key key, const Value &value) {
+		int b = bucket_of(key);
+		_buckets[b].push_back(value_type(key, value));
+		pushed(b);
+	}
+	void push(Key key, Value &&value) {
+		int b = bucket_of(key);
+		_buckets[b].push_back(value_type(key, std::move(value)));
+		pushed(b);
+	}
+	void pop() {
+		if (!_size) SJTU_THROW(container_is_empty);
+		refill();
+		_buckets[0].pop_back();
+		--_size;
+	}
+
+	size_t size() const { return _size; }
+	bool empty() const { return !_size; }
+	// the last key popped, below which no key may be pushed.
+	Key last() const { return _last; }
+
+private:
+	static constexpr int bits = sizeof(Key) * CHAR_BIT;
+
+	vector<value_type> _buckets[bits + 1];
+	Key _last = 0;
+	size_t _size = 0;
+	// where top found the minimum while bucket 0 is empty; -1 if not looked yet.
+	mutable int _min_bucket = -1;
+	mutable size_t _min_index = 0;
+
+private:
+	int bucket_of(Key key) const {
+		if (key < _last) SJTU_THROW(invalid_iterator);
+		return std::bit_width(static_cast<Key>(key ^ _last));
+	}
+
+	void find_min() const {
+		int i = 1;
+		while (_buckets[i].empty()) ++i;
+		const vector<value_type> &from = _buckets[i];
+		size_t m = 0;
+		for (size_t k = 1; k < from.size(); ++k)
+			if (from[k].first < from[m].first) m = k;
+		_min_bucket = i;
+		_min_index = m;
+	}
+	// keep the remembered minimum, of the buckets past 0, right after a push into bucket b.
+	void pushed(int b) {
+		++_size;
+		if (_min_bucket < 0 || !b) return;
+		const value_type &e = _buckets[b][_buckets[b].size() - 1];
+		if (e.first < _buckets[_min_bucket][_min_index].first) {
+			_min_bucket = b;
+			_min_index = _buckets[b].size() - 1;
+		}
+	}
+
+	/**
+	 * make bucket 0 non-empty, on a non-empty heap. Buckets below the first
+	 * non-empty one are empty, so if a push_back throws, moving everything
+	 * back fits the source bucket's capacity and cannot throw.
+	 */
+	void refill() {
+		if (!_buckets[0].empty()) return;
+		_min_bucket = -1;
+		int i = 1;
+		while (_buckets[i].empty()) ++i;
+		vector<value_type> &from = _buckets[i];
+		Key old_last = _last;
+		Key low = from[0].first;
+		for (size_t k = 1; k < from.size(); ++k)
+			if (from[k].first < low) low = from[k].first;
+		_last = low;
+		SJTU_TRY {
+			while (!from.empty()) {
+				value_type &e = from[from.size() - 1];
+				_buckets[std::bit_width(static_cast<Key>(e.first ^ low))].push_back(std::move(e));
+				from.pop_back();
+			}
+		} SJTU_CATCH_ALL {
+			for (int j = 0; j < i; ++j) {
+				vector<value_type> &to = _buckets[j];
+				while (!to.empty()) {
+					from.push_back(std::move(to[to.size() - 1]));
+					to.pop_back();
+				}
+			}
+			_last = old_last;
+			SJTU_RETHROW;
+		}
+	}
+};
+
+}// namespace sjtu
+
+#endif
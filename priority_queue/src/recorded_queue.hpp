@@ -0,0 +1,67 @@
+#ifndef SJTU_RECORDED_QUEUE_HPP
+#define SJTU_RECORDED_QUEUE_HPP
+
+#include "priority_queue.hpp"
+#include "trace.hpp"
+
+namespace sjtu {
+
+/**
+ * a priority_queue that appends every operation on it to a trace, see
+ * trace.hpp, to be replayed later against other policies by stlite-replay.
+ * pop is recorded under the key it removes and merge under the size of
+ * the other queue, whose keys are not recorded. Include dary_heap.hpp or
+ * pairing_heap.hpp first to record those policies.
+ */
+template<typename T,
+		 class Compare = std::less<T>,
+		 class Policy = leftist_heap,
+		 template<typename Type> class Alloc = node_pool>
+class recorded_queue {
+public:
+	using base_type = priority_queue<T, Compare, Policy, Alloc>;
+
+	explicit recorded_queue(const char *trace_path) : _trace(trace_path, trace_kind::priority_queue) {}
+	recorded_queue(const recorded_queue &) = delete;
+	recorded_queue &operator=(const recorded_queue &) = delete;
+
+	const T &top() const {
+		const T &t = _queue.top();
+		_trace.record(trace_top, trace_key(t));
+		return t;
+	}
+	void push(const T &e) {
+		_trace.record(trace_push, trace_key(e));
+		_queue.push(e);
+	}
+	void push(T &&e) {
+		_trace.record(trace_push, trace_key(e));
+		_queue.push(std::move(e));
+	}
+	template<class... Args>
+	void emplace(Args &&...args) {
+		push(T(std::forward<Args>(args)...));
+	}
+	void pop() {
+		_trace.record(trace_pop, _queue.empty() ? 0 : trace_key(_queue.top()));
+		_queue.pop();
+	}
+	size_t size() const { return _queue.size(); }
+	bool empty() const { return _queue.empty(); }
+	void merge(base_type &other) {
+		_trace.record(trace_merge, other.size());
+		_queue.merge(other);
+	}
+
+	base_type &base() noexcept { return _queue; }
+	const base_type &base() const noexcept { return _queue; }
+	const trace_writer &trace() const noexcept { return _trace; }
+
+private:
+	base_type _queue;
+	mutable trace_writer _trace;
+};
+
+}// namespace sjtu
+
+#endif
@@ -1,10 +1,19 @@
 #ifndef SJTU_UTILITY_HPP
 #define SJTU_UTILITY_HPP
 
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace sjtu {
 
+/**
+ * a pair that forwards its arguments, can be built piecewise, and is
+ * explicit exactly where std::pair is. The copy and move operations are
+ * defaulted, so pair<T1, T2> is trivially copyable when T1 and T2 are.
+ * tuple_size, tuple_element and get make structured bindings work.
+ */
 template<class T1, class T2>
 class pair {
 public:
@@ -13,15 +22,56 @@ public:
 	constexpr pair() : first(), second() {}
 	pair(const pair &other) = default;
 	pair(pair &&other) = default;
-	pair(const T1 &x, const T2 &y) : first(x), second(y) {}
-	template<class U1, class U2>
-	pair(U1 &&x, U2 &&y) : first(x), second(y) {}
+	pair &operator=(const pair &other) = default;
+	pair &operator=(pair &&other) = default;
+
+	constexpr explicit(!std::is_convertible_v<const T1 &, T1> || !std::is_convertible_v<const T2 &, T2>)
+			pair(const T1 &x, const T2 &y) : first(x), second(y) {}
+	template<class U1 = T1, class U2 = T2>
+		requires std::is_constructible_v<T1, U1> && std::is_constructible_v<T2, U2>
+	constexpr explicit(!std::is_convertible_v<U1, T1> || !std::is_convertible_v<U2, T2>)
+			pair(U1 &&x, U2 &&y) : first(std::forward<U1>(x)), second(std::forward<U2>(y)) {}
 	template<class U1, class U2>
-	pair(const pair<U1, U2> &other) : first(other.first), second(other.second) {}
+		requires std::is_constructible_v<T1, const U1 &> && std::is_constructible_v<T2, const U2 &>
+	constexpr explicit(!std::is_convertible_v<const U1 &, T1> || !std::is_convertible_v<const U2 &, T2>)
+			pair(const pair<U1, U2> &other) : first(other.first), second(other.second) {}
 	template<class U1, class U2>
-	pair(pair<U1, U2> &&other) : first(other.first), second(other.second) {}
+		requires std::is_constructible_v<T1, U1> && std::is_constructible_v<T2, U2>
+	constexpr explicit(!std::is_convertible_v<U1, T1> || !std::is_convertible_v<U2, T2>)
+			pair(pair<U1, U2> &&other) : first(std::forward<U1>(other.first)), second(std::forward<U2>(other.second)) {}
+	// first and second are built in place from the two argument tuples.
+	template<class... Args1, class... Args2>
+	constexpr pair(std::piecewise_construct_t, std::tuple<Args1...> x, std::tuple<Args2...> y)
+		: first(std::make_from_tuple<T1>(std::move(x))), second(std::make_from_tuple<T2>(std::move(y))) {}
 };
 
+template<class T1, class T2>
+pair(T1, T2) -> pair<T1, T2>;
+
+template<size_t I, class T1, class T2>
+constexpr std::tuple_element_t<I, pair<T1, T2>> &get(pair<T1, T2> &p) noexcept {
+	if constexpr (I == 0) return p.first;
+	else return p.second;
+}
+template<size_t I, class T1, class T2>
+constexpr const std::tuple_element_t<I, pair<T1, T2>> &get(const pair<T1, T2> &p) noexcept {
+	if constexpr (I == 0) return p.first;
+	else return p.second;
+}
+template<size_t I, class T1, class T2>
+constexpr std::tuple_element_t<I, pair<T1, T2>> &&get(pair<T1, T2> &&p) noexcept {
+	if constexpr (I == 0) return std::forward<T1>(p.first);
+	else return std::forward<T2>(p.second);
 }
 
+}
+
+template<class T1, class T2>
+struct std::tuple_size<sjtu::pair<T1, T2>> : std::integral_constant<size_t, 2> {};
+template<size_t I, class T1, class T2>
+struct std::tuple_element<I, sjtu::pair<T1, T2>> {
+	static_assert(I < 2, "sjtu::pair has two elements");
+	using type = std::conditional_t<I == 0, T1, T2>;
+};
+
 #endif
@@ -0,0 +1,119 @@
+// latency benchmark mode: every operation is timed on its own with
+// cycle_clock and recorded into an hdr_histogram per container and
+// operation, and the table gives p50, p99, p99.9, p99.99 and the maximum.
+// Throughput averages the spikes away; here they stand out: the max of
+// vector::push_back is the copy into the last buffer (with
+// incremental_growth, only its allocation), that of map::insert and
+// map::erase the longest rebalancing, that of a lazy queue's top the
+// consolidation of everything pushed since the last one.
+//
+// usage: stlite-latency [n] [container...]
+//
+// containers: vector, map, queue, or all three by default. Every row runs
+// n operations; the timer itself is the "timer" row, in every number
+// alike.
+#include "dary_heap.hpp"
+#include "incremental_vector.hpp"
+#include "latency.hpp"
+#include "map.hpp"
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+#include "vector.hpp"
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace {
+
+using sjtu::cycle_clock;
+using sjtu::hdr_histogram;
+
+unsigned long long seed = 88172645463325252ull;
+int Rand() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (int) (seed >> 33);
+}
+
+long long sink = 0;
+
+// op(i) timed for i in [0, n).
+template<class Op>
+void timed(const char *container, const char *name, int n, Op op) {
+	static hdr_histogram h;
+	h.reset();
+	for (int i = 0; i < n; ++i) {
+		uint64_t t0 = cycle_clock::now();
+		op(i);
+		uint64_t t1 = cycle_clock::now();
+		h.record(t1 - t0);
+	}
+	sjtu::print_latency_row(container, name, h);
+}
+
+template<class V>
+void vector_rows(const char *name, int n) {
+	V v;
+	timed(name, "push_back", n, [&](int i) { v.push_back(i); });
+	timed(name, "read", n, [&](int i) { sink += v[(long long) i * 7919 % n]; });
+	timed(name, "pop_back", n, [&](int) { v.pop_back(); });
+}
+
+template<class M>
+void map_rows(const char *name, int n, const std::vector<int> &keys) {
+	M m;
+	timed(name, "insert", n, [&](int i) { m.insert({keys[i], i}); });
+	timed(name, "find", n, [&](int i) { sink += m.find(keys[(long long) i * 7919 % n])->second; });
+	timed(name, "erase", n, [&](int i) { m.erase(m.find(keys[i])); });
+}
+
+template<class Q>
+void queue_rows(const char *name, int n, const std::vector<int> &keys) {
+	Q q;
+	timed(name, "push", n, [&](int i) { q.push(keys[i]); });
+	timed(name, "top", n, [&](int) { sink += q.top(); });
+	timed(name, "pop", n, [&](int) { q.pop(); });
+}
+
+template<class Policy>
+using sjtu_queue = sjtu::priority_queue<int, std::less<int>, Policy>;
+
+}// namespace
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? atoi(argv[1]) : 1 << 20;
+	if (n < 1) n = 1;
+	std::vector<std::string> names(argv + (argc > 1 ? 2 : 1), argv + argc);
+	if (names.empty()) names = {"vector", "map", "queue"};
+	std::vector<int> keys(n);
+	for (int i = 0; i < n; ++i) keys[i] = i;
+	for (int i = n - 1; i > 0; --i) std::swap(keys[i], keys[Rand() % (i + 1)]);
+
+	printf("%.3f ns per tick\n", cycle_clock::ns_per_tick());
+	sjtu::print_latency_header();
+	timed("timer", "empty", n, [](int) {});
+	for (const std::string &name : names) {
+		if (name == "vector") {
+			vector_rows<sjtu::vector<int>>("sjtu::vector<int>", n);
+			vector_rows<sjtu::vector<int, std::allocator<int>, sjtu::incremental_growth>>("sjtu::vector<int> (incremental)", n);
+			vector_rows<std::vector<int>>("std::vector<int>", n);
+		} else if (name == "map") {
+			map_rows<sjtu::map<int, int>>("sjtu::map<int, int>", n, keys);
+			map_rows<std::map<int, int>>("std::map<int, int>", n, keys);
+		} else if (name == "queue") {
+			queue_rows<sjtu_queue<sjtu::leftist_heap>>("priority_queue (leftist)", n, keys);
+			queue_rows<sjtu_queue<sjtu::lazy_leftist_heap>>("priority_queue (lazy)", n, keys);
+			queue_rows<sjtu_queue<sjtu::dary_heap<4>>>("priority_queue (dary<4>)", n, keys);
+			queue_rows<sjtu_queue<sjtu::pairing_heap>>("priority_queue (pairing)", n, keys);
+			queue_rows<std::priority_queue<int>>("std::priority_queue<int>", n, keys);
+		} else {
+			printf("unknown container %s\n", name.c_str());
+			return 1;
+		}
+	}
+	return sink == 42;
+}
@@ -0,0 +1,134 @@
+#ifndef SJTU_LATENCY_HPP
+#define SJTU_LATENCY_HPP
+
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace sjtu {
+
+/**
+ * a fast clock for timing single operations: the time stamp counter on
+ * x86, steady_clock elsewhere. Ticks become nanoseconds through
+ * ns_per_tick(), measured against steady_clock on first use.
+ */
+struct cycle_clock {
+	static uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+					   std::chrono::steady_clock::now().time_since_epoch())
+				.count();
+#endif
+	}
+	static double ns_per_tick() noexcept {
+		static const double ratio = calibrate();
+		return ratio;
+	}
+
+private:
+	static double calibrate() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+		using clock = std::chrono::steady_clock;
+		auto t0 = clock::now();
+		uint64_t c0 = now();
+		while (clock::now() - t0 < std::chrono::milliseconds(20)) {}
+		uint64_t c1 = now();
+		double ns = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+		return c1 > c0 ? ns / double(c1 - c0) : 1;
+#else
+		return 1;
+#endif
+	}
+};
+
+/**
+ * a histogram in the manner of HdrHistogram: values below 128 are counted
+ * exactly, larger ones in 64 buckets per power of two, so any percentile
+ * is off by less than 1/64 of its value, over the whole 64-bit range, in
+ * a fixed 30 KiB. Recording is a bit_width and an increment.
+ */
+class hdr_histogram {
+public:
+	static constexpr int sub_bits = 7;
+	static constexpr uint64_t half = uint64_t(1) << (sub_bits - 1);
+	static constexpr int buckets = (64 - sub_bits + 2) * half;
+
+	void record(uint64_t v) noexcept {
+		++_counts[index(v)];
+		++_total;
+		if (v > _max) _max = v;
+		_sum += v;
+	}
+
+	uint64_t count() const noexcept { return _total; }
+	uint64_t max() const noexcept { return _max; }
+	double mean() const noexcept { return _total ? double(_sum) / _total : 0; }
+	// the least value v with at least p percent of the values at or below it, up to the precision.
+	uint64_t percentile(double p) const noexcept {
+		if (!_total) return 0;
+		double want = p / 100 * _total;
+		uint64_t rank = uint64_t(want);
+		if (rank < want || !rank) ++rank;
+		if (rank >= _total) return _max;
+		uint64_t seen = 0;
+		for (int i = 0; i < buckets; ++i)
+			if ((seen += _counts[i]) >= rank) {
+				uint64_t hi = highest(i);
+				return hi < _max ? hi : _max;
+			}
+		return _max;
+	}
+	// f(low, high, count) for every bucket holding values.
+	template<class F>
+	void for_each(F &&f) const {
+		for (int i = 0; i < buckets; ++i)
+			if (_counts[i]) f(lowest(i), highest(i), _counts[i]);
+	}
+	void reset() noexcept { *this = hdr_histogram(); }
+
+private:
+	uint64_t _counts[buckets] = {};
+	uint64_t _total = 0, _max = 0, _sum = 0;
+
+	static int index(uint64_t v) noexcept {
+		if (v < 2 * half) return int(v);
+		int shift = std::bit_width(v) - sub_bits;
+		return int(shift * half + (v >> shift));
+	}
+	static uint64_t lowest(int i) noexcept {
+		if (i < int(2 * half)) return i;
+		int shift = i / int(half) - 1;
+		return (uint64_t(i) - shift * half) << shift;
+	}
+	static uint64_t highest(int i) noexcept {
+		if (i < int(2 * half)) return i;
+		int shift = i / int(half) - 1;
+		return lowest(i) + (uint64_t(1) << shift) - 1;
+	}
+};
+
+/**
+ * per-operation latencies of one container: the histograms are kept in
+ * clock ticks and printed in nanoseconds as one row per operation.
+ */
+inline void print_latency_header() {
+	printf("%-34s %-10s %10s %9s %9s %9s %9s %11s\n", "container", "operation", "ops", "p50", "p99", "p99.9",
+		   "p99.99", "max (ns)");
+}
+inline void print_latency_row(const char *container, const char *op, const hdr_histogram &h) {
+	if (!h.count()) return;
+	double k = cycle_clock::ns_per_tick();
+	printf("%-34s %-10s %10llu %9.0f %9.0f %9.0f %9.0f %11.0f\n", container, op, (unsigned long long) h.count(),
+		   h.percentile(50) * k, h.percentile(99) * k, h.percentile(99.9) * k, h.percentile(99.99) * k,
+		   h.max() * k);
+}
+
+}// namespace sjtu
+
+#endif
@@ -0,0 +1,290 @@
+// replays a trace, recorded by recorded_map, recorded_vector or
+// recorded_queue (see trace.hpp), against each implementation of its kind
+// of container, timing every operation on its own with cycle_clock, and
+// prints per implementation the throughput and per operation the
+// percentiles of its latencies, see latency.hpp. The clock reads around an
+// operation are in every number alike; stlite-latency measures them.
+//
+// usage: stlite-replay <trace> [implementation...]
+//
+// implementations, all of them by default:
+//   map:            sjtu, std, flat (a sorted vector), hash (std::unordered_map)
+//   vector:         sjtu, incremental (incremental_growth), std, deque
+//   priority_queue: leftist, lazy, dary, pairing, std
+//
+// Keys are replayed as recorded, which is the key itself for integral
+// keys and a hash otherwise; the hashes lose the order, so a map of
+// non-integral keys replays with its accesses in a different order.
+#include "dary_heap.hpp"
+#include "incremental_vector.hpp"
+#include "latency.hpp"
+#include "map.hpp"
+#include "pairing_heap.hpp"
+#include "priority_queue.hpp"
+#include "trace.hpp"
+#include "vector.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <map>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using sjtu::trace_reader;
+using clock_type = std::chrono::steady_clock;
+using sjtu::cycle_clock;
+
+struct xorshift {
+	uint64_t s;
+	explicit xorshift(uint64_t seed) : s(seed * 0x9e3779b97f4a7c15ull | 1) {}
+	uint64_t next() {
+		s ^= s << 13;
+		s ^= s >> 7;
+		s ^= s << 17;
+		return s;
+	}
+};
+
+// ---- map ----
+
+const char *map_ops[16] = {"insert", "erase", "find", "assign", nullptr, nullptr, nullptr, nullptr,
+						   nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, "clear"};
+
+// a map on a sorted vector: O(log n) lookups, O(n) updates, no nodes.
+class flat_map {
+public:
+	using value_type = std::pair<uint64_t, uint64_t>;
+	using iterator = std::vector<value_type>::iterator;
+
+	iterator begin() { return _v.begin(); }
+	iterator end() { return _v.end(); }
+	iterator find(uint64_t key) {
+		iterator it = lower(key);
+		return it != _v.end() && it->first == key ? it : _v.end();
+	}
+	std::pair<iterator, bool> insert(const value_type &value) {
+		iterator it = lower(value.first);
+		if (it != _v.end() && it->first == value.first) return {it, false};
+		return {_v.insert(it, value), true};
+	}
+	void erase(iterator it) { _v.erase(it); }
+	uint64_t &operator[](uint64_t key) { return insert({key, 0}).first->second; }
+	void clear() { _v.clear(); }
+
+private:
+	std::vector<value_type> _v;
+	iterator lower(uint64_t key) {
+		return std::lower_bound(_v.begin(), _v.end(), key, [](const value_type &a, uint64_t k) { return a.first < k; });
+	}
+};
+
+template<class M>
+struct map_replay {
+	M m;
+	static constexpr const char *const *ops = map_ops;
+
+	uint64_t apply(unsigned op, uint64_t key, uint64_t i) {
+		switch (op) {
+		case sjtu::trace_insert:
+			return m.insert(typename M::value_type(key, i)).second;
+		case sjtu::trace_erase: {
+			auto it = m.find(key);
+			if (it == m.end()) return 0;
+			m.erase(it);
+			return 1;
+		}
+		case sjtu::trace_find: {
+			auto it = m.find(key);
+			return it == m.end() ? 0 : it->second;
+		}
+		case sjtu::trace_assign:
+			return m[key] = i;
+		case sjtu::trace_clear:
+			m.clear();
+			return 0;
+		}
+		return 0;
+	}
+};
+
+// ---- vector ----
+
+const char *vector_ops[16] = {"push_back", "pop_back", "insert", "erase", "read", "write", nullptr, nullptr,
+							  nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, "clear"};
+
+template<class V>
+struct vector_replay {
+	V v;
+	static constexpr const char *const *ops = vector_ops;
+
+	// the recorded index, or one in range if the replay has drifted.
+	size_t index(uint64_t key, size_t n) const { return key < n ? key : key % n; }
+
+	uint64_t apply(unsigned op, uint64_t key, uint64_t i) {
+		size_t n = v.size();
+		switch (op) {
+		case sjtu::trace_push_back:
+			v.push_back(i);
+			return 1;
+		case sjtu::trace_pop_back:
+			if (!n) return 0;
+			v.pop_back();
+			return 1;
+		case sjtu::trace_insert_at:
+			v.insert(v.begin() + (key < n ? key : n), i);
+			return 1;
+		case sjtu::trace_erase_at:
+			if (!n) return 0;
+			v.erase(v.begin() + index(key, n));
+			return 1;
+		case sjtu::trace_read:
+			return n ? v[index(key, n)] : 0;
+		case sjtu::trace_write:
+			return n ? v[index(key, n)] = i : 0;
+		case sjtu::trace_clear:
+			v.clear();
+			return 0;
+		}
+		return 0;
+	}
+};
+
+// ---- priority_queue ----
+
+const char *queue_ops[16] = {"push", "pop", "top", "merge", nullptr, nullptr, nullptr, nullptr,
+							 nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, "clear"};
+
+template<class Q>
+struct queue_replay {
+	Q q, other;
+	static constexpr const char *const *ops = queue_ops;
+
+	// a merge of n unknown keys merges n random ones, made before the clock starts.
+	void prepare(unsigned op, uint64_t key, uint64_t i) {
+		if (op != sjtu::trace_merge) return;
+		xorshift r(i);
+		for (uint64_t k = std::min<uint64_t>(key, 1 << 20); k; --k) other.push(r.next() & sjtu::trace_key_mask);
+	}
+	uint64_t apply(unsigned op, uint64_t key, uint64_t) {
+		switch (op) {
+		case sjtu::trace_push:
+			q.push(key);
+			return 1;
+		case sjtu::trace_pop:
+			if (q.empty()) return 0;
+			q.pop();
+			return 1;
+		case sjtu::trace_top:
+			return q.empty() ? 0 : q.top();
+		case sjtu::trace_merge:
+			if constexpr (requires { q.merge(other); }) {
+				q.merge(other);
+			} else {
+				for (; !other.empty(); other.pop()) q.push(other.top());
+			}
+			return 1;
+		case sjtu::trace_clear:
+			q = Q();
+			return 0;
+		}
+		return 0;
+	}
+};
+
+// ---- the replay ----
+
+template<class Replay>
+void replay(const trace_reader &trace, const char *name) {
+	Replay r;
+	static sjtu::hdr_histogram hist[16];
+	for (sjtu::hdr_histogram &h : hist) h.reset();
+	const uint64_t *rec = trace.records();
+	uint64_t n = trace.size(), sink = 0;
+	auto start = clock_type::now();
+	for (uint64_t i = 0; i < n; ++i) {
+		unsigned op = trace_reader::op(rec[i]);
+		uint64_t key = trace_reader::key(rec[i]);
+		if constexpr (requires { r.prepare(op, key, i); }) r.prepare(op, key, i);
+		uint64_t t0 = cycle_clock::now();
+		sink += r.apply(op, key, i);
+		uint64_t t1 = cycle_clock::now();
+		hist[op].record(t1 - t0);
+	}
+	double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+	printf("%s: %.3fs, %.0f ops/s%s\n", name, seconds, n / seconds, sink == 42 ? " " : "");
+	sjtu::print_latency_header();
+	for (int op = 0; op < 16; ++op) sjtu::print_latency_row(name, Replay::ops[op] ? Replay::ops[op] : "?", hist[op]);
+}
+
+template<class Policy>
+using sjtu_queue = queue_replay<sjtu::priority_queue<uint64_t, std::less<uint64_t>, Policy>>;
+
+bool replay_one(const trace_reader &trace, const std::string &impl) {
+	const char *name = impl.c_str();
+	switch (trace.kind()) {
+	case sjtu::trace_kind::map:
+		if (impl == "sjtu") return replay<map_replay<sjtu::map<uint64_t, uint64_t>>>(trace, name), true;
+		if (impl == "std") return replay<map_replay<std::map<uint64_t, uint64_t>>>(trace, name), true;
+		if (impl == "flat") return replay<map_replay<flat_map>>(trace, name), true;
+		if (impl == "hash") return replay<map_replay<std::unordered_map<uint64_t, uint64_t>>>(trace, name), true;
+		break;
+	case sjtu::trace_kind::vector:
+		if (impl == "sjtu") return replay<vector_replay<sjtu::vector<uint64_t>>>(trace, name), true;
+		if (impl == "incremental")
+			return replay<vector_replay<sjtu::vector<uint64_t, std::allocator<uint64_t>, sjtu::incremental_growth>>>(trace, name), true;
+		if (impl == "std") return replay<vector_replay<std::vector<uint64_t>>>(trace, name), true;
+		if (impl == "deque") return replay<vector_replay<std::deque<uint64_t>>>(trace, name), true;
+		break;
+	case sjtu::trace_kind::priority_queue:
+		if (impl == "leftist") return replay<sjtu_queue<sjtu::leftist_heap>>(trace, name), true;
+		if (impl == "lazy") return replay<sjtu_queue<sjtu::lazy_leftist_heap>>(trace, name), true;
+		if (impl == "dary") return replay<sjtu_queue<sjtu::dary_heap<4>>>(trace, name), true;
+		if (impl == "pairing") return replay<sjtu_queue<sjtu::pairing_heap>>(trace, name), true;
+		if (impl == "std") return replay<queue_replay<std::priority_queue<uint64_t>>>(trace, name), true;
+		break;
+	}
+	printf("unknown implementation %s\n", name);
+	return false;
+}
+
+}// namespace
+
+int main(int argc, char **argv) {
+	if (argc < 2) {
+		printf("usage: %s <trace> [implementation...]\n", argv[0]);
+		return 2;
+	}
+	trace_reader trace(argv[1]);
+	if (!trace.ok()) {
+		printf("%s: not a trace\n", argv[1]);
+		return 1;
+	}
+	std::vector<std::string> impls(argv + 2, argv + argc);
+	// trace_reader accepts only the three kinds.
+	const char *kind = nullptr;
+	std::vector<std::string> all;
+	switch (trace.kind()) {
+	case sjtu::trace_kind::map:
+		kind = "map", all = {"sjtu", "std", "flat", "hash"};
+		break;
+	case sjtu::trace_kind::vector:
+		kind = "vector", all = {"sjtu", "incremental", "std", "deque"};
+		break;
+	case sjtu::trace_kind::priority_queue:
+		kind = "priority_queue", all = {"leftist", "lazy", "dary", "pairing", "std"};
+		break;
+	}
+	if (impls.empty()) impls = all;
+	printf("%s: %s, %llu operations\n", argv[1], kind, (unsigned long long) trace.size());
+	bool ok = true;
+	for (const std::string &impl : impls) ok &= replay_one(trace, impl);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+// records a sample trace per kind of container through the recorded_*
+// wrappers, as <prefix>map.trace, <prefix>vector.trace and
+// <prefix>queue.trace, for stlite-replay to run; the workloads are a
+// stand-in for traces taken from a real program.
+//
+// usage: stlite-trace-sample [prefix] [ops]
+#include "dary_heap.hpp"
+#include "recorded_map.hpp"
+#include "recorded_queue.hpp"
+#include "recorded_vector.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+
+namespace {
+
+struct xorshift {
+	unsigned long long s;
+	explicit xorshift(unsigned long long seed) : s(seed * 0x9e3779b97f4a7c15ull | 1) {}
+	unsigned long long next() {
+		s ^= s << 13;
+		s ^= s >> 7;
+		s ^= s << 17;
+		return s;
+	}
+};
+
+// a cache-like mix: mostly lookups of a skewed key set, some churn.
+unsigned long long record_map(const std::string &path, long long ops) {
+	sjtu::recorded_map<int, int> m(path.c_str());
+	xorshift r(1);
+	for (long long i = 0; i < ops; ++i) {
+		unsigned long long x = r.next();
+		int key = (int) ((x >> 8) % (x & 1 ? 1024 : 65536));
+		switch (x >> 60) {
+		case 0:
+		case 1: {
+			auto it = m.find(key);
+			if (it != m.end()) m.erase(it);
+			break;
+		}
+		case 2:
+		case 3:
+		case 4:
+			m[key] = (int) i;
+			break;
+		case 5:
+			m.insert({key, (int) i});
+			break;
+		default:
+			m.count(key);
+		}
+	}
+	return m.trace().count();
+}
+
+// a buffer filled, read and drained in waves.
+unsigned long long record_vector(const std::string &path, long long ops) {
+	sjtu::recorded_vector<int> v(path.c_str());
+	xorshift r(2);
+	for (long long i = 0; i < ops; ++i) {
+		unsigned long long x = r.next();
+		size_t n = v.size();
+		bool filling = i / 4096 % 3 != 2;
+		if (!n || (filling && x % 2)) v.push_back((int) i);
+		else if (!filling && x % 2) v.pop_back();
+		else if (x % 4 == 2) v[(x >> 8) % n] = (int) i;
+		else (void) std::as_const(v)[(x >> 8) % n];
+	}
+	v.clear();
+	return v.trace().count();
+}
+
+// a scheduler: pushes and pops around a steady size, an occasional merge.
+unsigned long long record_queue(const std::string &path, long long ops) {
+	sjtu::recorded_queue<int, std::less<int>, sjtu::dary_heap<4>> q(path.c_str());
+	xorshift r(3);
+	for (long long i = 0; i < ops; ++i) {
+		unsigned long long x = r.next();
+		if (x % 1000 == 0) {
+			sjtu::priority_queue<int, std::less<int>, sjtu::dary_heap<4>> other;
+			for (int k = 0; k < 64; ++k) other.push((int) (r.next() >> 40));
+			q.merge(other);
+		} else if (q.size() < 1024 || x % 2) {
+			q.push((int) (x >> 40));
+		} else {
+			q.top();
+			q.pop();
+		}
+	}
+	return q.trace().count();
+}
+
+}// namespace
+
+int main(int argc, char **argv) {
+	std::string prefix = argc > 1 ? argv[1] : "";
+	long long ops = argc > 2 ? atoll(argv[2]) : 1000000;
+	unsigned long long a = record_map(prefix + "map.trace", ops);
+	unsigned long long b = record_vector(prefix + "vector.trace", ops);
+	unsigned long long c = record_queue(prefix + "queue.trace", ops);
+	printf("recorded %llu map, %llu vector and %llu priority_queue operations\n", a, b, c);
+	return a && b && c ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+# operation traces, see map/src/trace.hpp. stlite-trace-sample records a
+# sample trace per container through the recorded_* wrappers and
+# stlite-replay runs a trace against every implementation of its kind; the
+# tests record and replay a short one under the label trace.
+# stlite-latency is the latency benchmark, see latency.cpp; its test only
+# checks that it runs.
+
+set(trace_includes ${CMAKE_CURRENT_SOURCE_DIR}/vector/src ${CMAKE_CURRENT_SOURCE_DIR}/map/src ${CMAKE_CURRENT_SOURCE_DIR}/priority_queue/src)
+add_executable(stlite-replay "${CMAKE_CURRENT_LIST_DIR}/replay.cpp")
+target_include_directories(stlite-replay PRIVATE ${trace_includes})
+add_executable(stlite-trace-sample "${CMAKE_CURRENT_LIST_DIR}/sample.cpp")
+target_include_directories(stlite-trace-sample PRIVATE ${trace_includes})
+add_executable(stlite-latency "${CMAKE_CURRENT_LIST_DIR}/latency.cpp")
+target_include_directories(stlite-latency PRIVATE ${trace_includes})
+
+set(trace_prefix "${CMAKE_BINARY_DIR}/sample-")
+add_test(NAME trace-sample COMMAND stlite-trace-sample ${trace_prefix} 100000)
+set_tests_properties(trace-sample PROPERTIES LABELS trace FIXTURES_SETUP trace)
+foreach (kind map vector queue)
+    add_test(NAME trace-replay-${kind} COMMAND stlite-replay ${trace_prefix}${kind}.trace)
+    math(EXPR timeout "20 * ${STLITE_TIMEOUT_SCALE}")
+    set_tests_properties(trace-replay-${kind} PROPERTIES LABELS trace FIXTURES_REQUIRED trace TIMEOUT ${timeout})
+endforeach ()
+
+add_test(NAME trace-latency COMMAND stlite-latency 10000)
+set_tests_properties(trace-latency PROPERTIES LABELS trace TIMEOUT ${timeout})
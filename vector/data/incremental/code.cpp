@@ -0,0 +1,125 @@
+#include "incremental_vector.hpp"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+template<class T>
+using incremental = sjtu::vector<T, std::allocator<T>, sjtu::incremental_growth>;
+
+// counts the elements constructed, to bound the work of each push_back.
+struct counted {
+	static inline int made = 0;
+	int v;
+	counted(int v) : v(v) { ++made; }
+	counted(const counted &o) : v(o.v) { ++made; }
+	counted(counted &&o) noexcept : v(o.v) { ++made; }
+	counted &operator=(const counted &) = default;
+	counted &operator=(counted &&) noexcept = default;
+};
+
+unsigned long long seed = 88172645463325252ull;
+unsigned Rand() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (unsigned) (seed >> 32);
+}
+
+template<class T>
+bool same(const incremental<T> &a, const std::vector<T> &b) {
+	if (a.size() != b.size()) return false;
+	for (size_t i = 0; i < b.size(); ++i)
+		if (!(a[i] == b[i])) return false;
+	size_t i = 0;
+	for (auto it = a.cbegin(); it != a.cend(); ++it, ++i)
+		if (!(*it == b[i])) return false;
+	return i == b.size();
+}
+
+template<class T, class Make>
+bool random_ops(int steps, Make make) {
+	bool ok = true;
+	incremental<T> a;
+	std::vector<T> b;
+	for (int step = 0; step < steps; ++step) {
+		unsigned r = Rand() % 100;
+		if (r < 60 || b.empty()) {
+			T x = make(step);
+			a.push_back(x);
+			b.push_back(x);
+		} else if (r < 90) {
+			a.pop_back();
+			b.pop_back();
+		} else if (r < 99) {
+			size_t i = Rand() % b.size();
+			a[i] = make(-step);
+			b[i] = make(-step);
+		} else if (r % 2) {
+			size_t i = Rand() % (b.size() + 1);
+			a.insert(i, make(step));
+			b.insert(b.begin() + i, make(step));
+		} else {
+			size_t i = Rand() % b.size();
+			a.erase(i);
+			b.erase(b.begin() + i);
+		}
+		if (step % 9973 == 0) ok &= same(a, b);
+	}
+	ok &= same(a, b);
+	incremental<T> c(a), d;
+	d = a;
+	ok &= same(c, b) && same(d, b);
+	incremental<T> e(std::move(c));
+	ok &= same(e, b) && c.empty();
+	a.clear();
+	ok &= a.empty() && !a.migrating();
+	return ok;
+}
+
+int main()
+{
+	bool ok = true;
+
+	// no emplace_back constructs more than the new element and two moved ones.
+	incremental<counted> v;
+	int worst = 0, grew = 0;
+	for (int i = 0; i < 100000; ++i) {
+		int before = counted::made;
+		bool was = v.migrating();
+		v.emplace_back(i);
+		grew += !was && v.migrating();
+		if (counted::made - before > worst) worst = counted::made - before;
+	}
+	ok &= worst <= 3 && grew == 15;
+	for (int i = 0; i < 100000; ++i) ok &= v[i].v == i;
+
+	// while migrating, both buffers are read, and iterators survive the moves.
+	incremental<int> w;
+	for (int i = 0; i < 1024; ++i) w.push_back(i);
+	w.push_back(1024);
+	ok &= w.migrating();
+	auto it = w.begin() + 1000;
+	long long sum = 0;
+	for (int i = 0; i < 1025; ++i) sum += w[i];
+	ok &= sum == 1024 * 1025 / 2 && *it == 1000;
+	for (int i = 0; i < 600; ++i) w.push_back(1025 + i);
+	ok &= !w.migrating() && *it == 1000 && w.back() == 1624;
+	// popping into the old buffer shortens what is left to move.
+	for (int i = 0; i < 1024; ++i) w.push_back(i);
+	for (int i = 0; i < 2000; ++i) w.pop_back();
+	ok &= !w.migrating() && w.size() == 649 && w.back() == 648;
+	// an element of the vector may be pushed while the buffer is full.
+	incremental<std::string> s;
+	s.push_back("a");
+	s.push_back("b");
+	s.push_back(s[0]);
+	s.emplace_back(s[1]);
+	ok &= s.size() == 4 && s[2] == "a" && s[3] == "b";
+
+	ok &= random_ops<int>(200000, [](int i) { return i; });
+	// fewer steps: the vector grows to a third of them, and every insert and erase moves its strings.
+	ok &= random_ops<std::string>(20000, [](int i) { return std::to_string(i) + "-padding-past-sso"; });
+
+	puts(ok ? "ok" : "failed");
+	return 0;
+}
@@ -0,0 +1,45 @@
+#include "recorded_vector.hpp"
+#include <cstdio>
+#include <unistd.h>
+#include <utility>
+
+using sjtu::trace_reader;
+
+int main()
+{
+	bool ok = true;
+	const char *path = "vector-trace.bin";
+	{
+		sjtu::recorded_vector<int> v(path);
+		// front and back of an empty vector throw as vector's do, and record nothing.
+		try {
+			(void) v.back();
+			ok = false;
+		} catch (sjtu::container_is_empty &) {}
+		try {
+			(void) v.front();
+			ok = false;
+		} catch (sjtu::container_is_empty &) {}
+		ok &= v.trace().count() == 0;
+		for (int i = 0; i < 10; ++i) v.push_back(i);
+		v[3] = 30;
+		ok &= std::as_const(v)[3] == 30;
+		v.insert(5, 50);
+		v.erase(0);
+		v.pop_back();
+		ok &= v.size() == 9 && v.base()[2] == 30;
+		v.clear();
+	}
+	trace_reader t(path);
+	ok &= t.ok() && t.kind() == sjtu::trace_kind::vector && t.size() == 16;
+	const uint64_t *r = t.records();
+	for (int i = 0; i < 10; ++i) ok &= trace_reader::op(r[i]) == sjtu::trace_push_back && trace_reader::key(r[i]) == (uint64_t) i;
+	ok &= r[10] == (uint64_t(sjtu::trace_write) << 60 | 3) && r[11] == (uint64_t(sjtu::trace_read) << 60 | 3);
+	ok &= trace_reader::op(r[12]) == sjtu::trace_insert_at && trace_reader::key(r[12]) == 5;
+	ok &= trace_reader::op(r[13]) == sjtu::trace_erase_at && trace_reader::key(r[13]) == 0;
+	ok &= trace_reader::op(r[14]) == sjtu::trace_pop_back && trace_reader::key(r[14]) == 10;
+	ok &= trace_reader::op(r[15]) == sjtu::trace_clear;
+	unlink(path);
+	puts(ok ? "ok" : "failed");
+	return 0;
+}
@@ -0,0 +1,349 @@
+#ifndef SJTU_INCREMENTAL_VECTOR_HPP
+#define SJTU_INCREMENTAL_VECTOR_HPP
+
+#include "exceptions.hpp"
+#include "vector.hpp"
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace sjtu {
+
+/**
+ * vector with incremental_growth: when push_back finds the buffer full, it
+ * allocates one twice as large and puts only the new element there. The
+ * old elements stay where they are, and every later push_back or
+ * emplace_back moves the next two of them over, so no push_back does more
+ * than O(1) work besides the allocation itself. While elements remain in
+ * the old buffer, indexing takes them from there, at the cost of one more
+ * comparison.
+ *
+ * Two moves per push always finish a migration before the new buffer
+ * fills, as the elements left to move never exceed twice the free slots:
+ * growing from c elements leaves c - 2 of them and c - 1 slots, a push
+ * takes one slot and two elements, and a pop frees a slot and takes at
+ * most one. insert and erase in the middle, which are O(n) anyway, finish
+ * any migration first.
+ *
+ * Iterators hold an index, so they survive the migration; references and
+ * pointers to elements are invalidated by push_back and emplace_back. The
+ * move constructor of T must not throw.
+ */
+template<typename T, typename Alloc>
+class vector<T, Alloc, incremental_growth> {
+	static_assert(std::is_nothrow_move_constructible_v<T>, "incremental growth moves elements after the push");
+
+private:
+	class iterator_base_cmp {
+	public:
+		friend class vector;
+		iterator_base_cmp(const vector *owner, size_t pos) : owner(owner), pos(pos) {}
+		bool operator==(const iterator_base_cmp &rhs) const { return pos == rhs.pos; }
+		bool operator!=(const iterator_base_cmp &rhs) const { return pos != rhs.pos; }
+
+	protected:
+		const vector *owner;
+		size_t pos;
+	};
+
+	template<bool is_const>
+	class iterator_common : public iterator_base_cmp {
+	public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = T;
+		using pointer = typename std::conditional<is_const, const T *, T *>::type;
+		using reference = typename std::conditional<is_const, const T &, T &>::type;
+		using iterator_category = std::output_iterator_tag;
+
+		using iterator_base_cmp::iterator_base_cmp;
+
+		iterator_common operator+(const int &n) const {
+			return {this->owner, this->pos + n};
+		}
+		iterator_common operator-(const int &n) const {
+			return {this->owner, this->pos - n};
+		}
+
+		int operator-(const iterator_common &rhs) const {
+			if (this->owner != rhs.owner) SJTU_THROW(invalid_iterator);
+			return int(this->pos - rhs.pos);
+		}
+
+		iterator_common &operator+=(const int &n) {
+			this->pos += n;
+			return *this;
+		}
+
+		iterator_common &operator-=(const int &n) {
+			this->pos -= n;
+			return *this;
+		}
+
+		iterator_common operator++(int) {
+			iterator_common ret = *this;
+			++this->pos;
+			return ret;
+		}
+		iterator_common &operator++() {
+			++this->pos;
+			return *this;
+		}
+		iterator_common operator--(int) {
+			iterator_common ret = *this;
+			--this->pos;
+			return ret;
+		}
+		iterator_common &operator--() {
+			--this->pos;
+			return *this;
+		}
+		reference operator*() const {
+			return *this->owner->slot(this->pos);
+		}
+		pointer operator->() const { return this->owner->slot(this->pos); }
+	};
+
+public:
+	using iterator = iterator_common<false>;
+	using const_iterator = iterator_common<true>;
+
+	vector() = default;
+	vector(const vector &other) { copy_from(other); }
+	vector(vector &&other) noexcept : alloc{std::move(other.alloc)} { take(other); }
+
+	~vector() { clear(); }
+
+	vector &operator=(const vector &other) {
+		if (this == &other) return *this;
+		clear();
+		copy_from(other);
+		return *this;
+	}
+
+	vector &operator=(vector &&other) {
+		if (this == &other) return *this;
+		clear();
+		alloc = std::move(other.alloc);
+		take(other);
+		return *this;
+	}
+
+	T &at(const size_t &pos) {
+		return const_cast<T &>(const_cast<const vector *>(this)->at(pos));
+	}
+
+	const T &at(const size_t &pos) const {
+		if (pos >= size()) SJTU_THROW(index_out_of_bound);
+		return *slot(pos);
+	}
+	T &operator[](const size_t &pos) { return at(pos); }
+	const T &operator[](const size_t &pos) const { return at(pos); }
+
+	const T &front() const {
+		if (start == finish) SJTU_THROW(container_is_empty);
+		return *slot(0);
+	}
+
+	const T &back() const {
+		if (start == finish) SJTU_THROW(container_is_empty);
+		return *slot(size() - 1);
+	}
+
+	iterator begin() { return {this, 0}; }
+	const_iterator begin() const { return {this, 0}; }
+	const_iterator cbegin() const { return {this, 0}; }
+	iterator end() { return {this, size()}; }
+	const_iterator end() const { return {this, size()}; }
+	const_iterator cend() const { return {this, size()}; }
+
+	[[nodiscard]] bool empty() const { return start == finish; }
+	[[nodiscard]] size_t size() const { return finish - start; }
+	// whether elements are still waiting in the old buffer.
+	[[nodiscard]] bool migrating() const { return old != nullptr; }
+
+	void clear() {
+		size_t sz = size();
+		for (size_t i = 0; i < sz; ++i) slot(i)->~T();
+		release_old();
+		if (start) alloc.deallocate(start, bound - start);
+		start = finish = bound = nullptr;
+	}
+
+	iterator insert(iterator pos, const T &value) {
+		if (pos.owner != this || pos.pos > size()) SJTU_THROW(index_out_of_bound);
+		emplace_back(value);
+		complete();
+		T *dest = start + pos.pos;
+		if (dest != finish - 1) {
+			T tmp(std::move(finish[-1]));
+			for (T *p = finish - 1; p != dest; --p) *p = std::move(p[-1]);
+			*dest = std::move(tmp);
+		}
+		return pos;
+	}
+
+	iterator insert(const size_t &ind, const T &value) {
+		return insert(begin() + ind, value);
+	}
+
+	iterator erase(iterator pos) {
+		if (pos.owner != this || pos.pos >= size()) SJTU_THROW(index_out_of_bound);
+		complete();
+		for (T *p = start + pos.pos + 1; p != finish; ++p) p[-1] = std::move(*p);
+		--finish;
+		finish->~T();
+		return pos;
+	}
+
+	iterator erase(const size_t &ind) {
+		return erase(begin() + ind);
+	}
+
+	void push_back(const T &value) { emplace_back(value); }
+	void push_back(T &&value) { emplace_back(std::move(value)); }
+
+	/**
+	 * the new element is constructed before anything moves, so args may
+	 * refer to an element of this vector, and nothing changes if the
+	 * construction throws.
+	 */
+	template<class... Args>
+	T &emplace_back(Args &&...args) {
+		size_t sz = size();
+		if (finish != bound) {
+			new (finish) T(std::forward<Args>(args)...);
+			++finish;
+		} else {
+			// the migration is over by now, see above.
+			size_t cap = bound - start;
+			size_t new_cap = cap ? cap * 2 : 2;
+			T *dest = alloc.allocate(new_cap);
+			SJTU_TRY {
+				new (dest + sz) T(std::forward<Args>(args)...);
+			} SJTU_CATCH_ALL {
+				alloc.deallocate(dest, new_cap);
+				SJTU_RETHROW;
+			}
+			count_reallocation(sz);
+			if (sz) {
+				old = start;
+				old_cap = cap;
+				moved = 0;
+				old_end = sz;
+			} else if (start) {
+				alloc.deallocate(start, cap);
+			}
+			start = dest;
+			finish = dest + sz + 1;
+			bound = dest + new_cap;
+		}
+		migrate(migrate_per_push);
+		return start[sz];
+	}
+
+	void pop_back() {
+		if (start == finish) SJTU_THROW(container_is_empty);
+		size_t last = size() - 1;
+		slot(last)->~T();
+		--finish;
+		if (last - moved < old_end - moved) {
+			old_end = last;
+			if (moved == old_end) release_old();
+		}
+	}
+
+#ifdef SJTU_STATS
+	struct stats_type {
+		size_t reallocations = 0;// buffers replaced by a larger one
+		size_t bytes_moved = 0;  // bytes of elements to relocate into them
+	};
+	const stats_type &stats() const { return _stats; }
+#else
+	struct stats_type {};
+#endif
+
+private:
+	static constexpr size_t migrate_per_push = 2;
+
+	[[no_unique_address]] Alloc alloc{};
+	// the current buffer; its slots [moved, old_end) are empty, those
+	// elements are still in old.
+	T *start = nullptr, *finish = nullptr, *bound = nullptr;
+	T *old = nullptr;
+	size_t old_cap = 0, moved = 0, old_end = 0;
+	[[no_unique_address]] stats_type _stats;
+
+	T *slot(size_t pos) const {
+		return pos - moved < old_end - moved ? old + pos : start + pos;
+	}
+
+	// move up to n elements over from the old buffer, and free it once empty.
+	void migrate(size_t n) noexcept {
+		if (!old) return;
+		size_t end = old_end - moved < n ? old_end : moved + n;
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			std::memcpy(static_cast<void *>(start + moved), old + moved, (end - moved) * sizeof(T));
+			moved = end;
+		} else {
+			for (; moved != end; ++moved) {
+				new (start + moved) T(std::move(old[moved]));
+				old[moved].~T();
+			}
+		}
+		if (moved == old_end) release_old();
+	}
+	void complete() noexcept {
+		if (old) migrate(old_end - moved);
+	}
+	void release_old() noexcept {
+		if (old) alloc.deallocate(old, old_cap);
+		old = nullptr;
+		old_cap = moved = old_end = 0;
+	}
+
+	void copy_from(const vector &other) {
+		size_t sz = other.size();
+		if (!sz) return;
+		T *dest = alloc.allocate(sz);
+		size_t made = 0;
+		SJTU_TRY {
+			for (; made < sz; ++made) new (dest + made) T(other[made]);
+		} SJTU_CATCH_ALL {
+			while (made) dest[--made].~T();
+			alloc.deallocate(dest, sz);
+			SJTU_RETHROW;
+		}
+		start = dest;
+		finish = bound = dest + sz;
+	}
+
+	void take(vector &other) noexcept {
+		start = other.start;
+		finish = other.finish;
+		bound = other.bound;
+		old = other.old;
+		old_cap = other.old_cap;
+		moved = other.moved;
+		old_end = other.old_end;
+		other.start = other.finish = other.bound = other.old = nullptr;
+		other.old_cap = other.moved = other.old_end = 0;
+	}
+
+	// a new buffer that is to take over n elements; the first buffer does not count.
+	void count_reallocation([[maybe_unused]] size_t n) {
+#ifdef SJTU_STATS
+		if (!start) return;
+		++_stats.reallocations;
+		_stats.bytes_moved += n * sizeof(T);
+		counters::vector_reallocations.add(1);
+		counters::vector_bytes_moved.add(n * sizeof(T));
+#endif
+	}
+};
+
+}// namespace sjtu
+
+#endif
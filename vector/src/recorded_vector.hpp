@@ -0,0 +1,92 @@
+#ifndef SJTU_RECORDED_VECTOR_HPP
+#define SJTU_RECORDED_VECTOR_HPP
+
+#include "trace.hpp"
+#include "vector.hpp"
+
+namespace sjtu {
+
+/**
+ * a vector that appends every operation on it to a trace, see trace.hpp, to
+ * be replayed later by stlite-replay. The key of a record is the index
+ * operated on. Element access through a const vector is recorded as a
+ * read, through a non-const one as a write, as the two cannot be told
+ * apart; iteration goes through base() and is not recorded.
+ */
+template<typename T, typename Alloc = std::allocator<T>>
+class recorded_vector {
+public:
+	using base_type = vector<T, Alloc>;
+	using iterator = typename base_type::iterator;
+	using const_iterator = typename base_type::const_iterator;
+
+	explicit recorded_vector(const char *trace_path) : _trace(trace_path, trace_kind::vector) {}
+	recorded_vector(const recorded_vector &) = delete;
+	recorded_vector &operator=(const recorded_vector &) = delete;
+
+	T &at(const size_t &pos) {
+		_trace.record(trace_write, pos);
+		return _vec.at(pos);
+	}
+	const T &at(const size_t &pos) const {
+		_trace.record(trace_read, pos);
+		return _vec.at(pos);
+	}
+	T &operator[](const size_t &pos) { return at(pos); }
+	const T &operator[](const size_t &pos) const { return at(pos); }
+
+	const T &front() const {
+		if (_vec.empty()) SJTU_THROW(container_is_empty);
+		return at(0);
+	}
+	const T &back() const {
+		if (_vec.empty()) SJTU_THROW(container_is_empty);
+		return at(_vec.size() - 1);
+	}
+
+	iterator begin() { return _vec.begin(); }
+	const_iterator begin() const { return _vec.begin(); }
+	const_iterator cbegin() const { return _vec.cbegin(); }
+	iterator end() { return _vec.end(); }
+	const_iterator end() const { return _vec.end(); }
+	const_iterator cend() const { return _vec.cend(); }
+
+	[[nodiscard]] bool empty() const { return _vec.empty(); }
+	[[nodiscard]] size_t size() const { return _vec.size(); }
+
+	void clear() {
+		_trace.record(trace_clear, 0);
+		_vec.clear();
+	}
+	iterator insert(const size_t &ind, const T &value) {
+		_trace.record(trace_insert_at, ind);
+		return _vec.insert(ind, value);
+	}
+	iterator erase(const size_t &ind) {
+		_trace.record(trace_erase_at, ind);
+		return _vec.erase(ind);
+	}
+	void push_back(const T &value) { emplace_back(value); }
+	void push_back(T &&value) { emplace_back(std::move(value)); }
+	template<class... Args>
+	T &emplace_back(Args &&...args) {
+		_trace.record(trace_push_back, _vec.size());
+		return _vec.emplace_back(std::forward<Args>(args)...);
+	}
+	void pop_back() {
+		_trace.record(trace_pop_back, _vec.size());
+		_vec.pop_back();
+	}
+
+	base_type &base() noexcept { return _vec; }
+	const base_type &base() const noexcept { return _vec; }
+	const trace_writer &trace() const noexcept { return _trace; }
+
+private:
+	base_type _vec;
+	mutable trace_writer _trace;
+};
+
+}// namespace sjtu
+
+#endif
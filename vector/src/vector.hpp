@@ -2,13 +2,37 @@
 #define SJTU_VECTOR_HPP
 
 #include "exceptions.hpp"
+#include "stats.hpp"
 
 #include <climits>
 #include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace sjtu {
-template<typename T, typename Alloc = std::allocator<T>>
+
+#ifdef SJTU_STATS
+// process-wide totals of vector::stats().
+namespace counters {
+inline stat_counter vector_reallocations{"vector.reallocations"};
+inline stat_counter vector_bytes_moved{"vector.bytes_moved"};
+}// namespace counters
+#endif
+
+// growth policies for vector. With doubling_growth the push_back that
+// finds the buffer full moves every element into one twice as large;
+// incremental_growth, in incremental_vector.hpp, spreads the move over
+// the following pushes.
+struct doubling_growth {};
+struct incremental_growth {};
+
+template<typename T, typename Alloc = std::allocator<T>, class Growth = doubling_growth>
 class vector {
+	static_assert(std::is_same_v<Growth, doubling_growth>, "incremental_growth needs incremental_vector.hpp");
+
 private:
 	class iterator_base_cmp {
 	public:
@@ -40,7 +64,7 @@ private:
 		}
 
 		int operator-(const iterator_common &rhs) const {
-			if (this->start != rhs.start) throw invalid_iterator{};
+			if (this->start != rhs.start) SJTU_THROW(invalid_iterator);
 			return this->cur - rhs.cur;
 		}
 
@@ -113,23 +137,23 @@ public:
 	}
 
 	T &at(const size_t &pos) {
-		return const_cast<T &>(const_cast<const vector<T> *>(this)->at(pos));
+		return const_cast<T &>(const_cast<const vector *>(this)->at(pos));
 	}
 
 	const T &at(const size_t &pos) const {
-		if (pos >= finish - start) throw index_out_of_bound{};
+		if (pos >= finish - start) SJTU_THROW(index_out_of_bound);
 		return start[pos];
 	}
 	T &operator[](const size_t &pos) { return at(pos); }
 	const T &operator[](const size_t &pos) const { return at(pos); }
 
 	const T &front() const {
-		if (start == finish) throw container_is_empty{};
+		if (start == finish) SJTU_THROW(container_is_empty);
 		return *start;
 	}
 
 	const T &back() const {
-		if (start == finish) throw container_is_empty{};
+		if (start == finish) SJTU_THROW(container_is_empty);
 		return *(finish - 1);
 	}
 
@@ -143,7 +167,7 @@ public:
 	[[nodiscard]] bool empty() const { return start == finish; }
 	[[nodiscard]] size_t size() const { return finish - start; }
 	void clear() {
-		size_t sz = finish - start;
+		size_t sz = bound - start;
 		while (finish != start) {
 			--finish;
 			finish->~T();
@@ -152,7 +176,7 @@ public:
 		start = finish = bound = nullptr;
 	}
 	iterator insert(iterator pos, const T &value) {
-		if (pos.start != start || pos.cur > finish) throw index_out_of_bound{};
+		if (pos.start != start || pos.cur > finish) SJTU_THROW(index_out_of_bound);
 		if (finish == bound) {
 			T *dest = register_new_space();
 			T *mid = dest + (pos.cur - start);
@@ -179,7 +203,7 @@ public:
 	}
 
 	iterator erase(iterator pos) {
-		if (pos.start != start || pos.cur >= finish) throw index_out_of_bound{};
+		if (pos.start != start || pos.cur >= finish) SJTU_THROW(index_out_of_bound);
 		T *cur = pos.cur;
 		cur->~T();
 		++cur;
@@ -200,33 +224,68 @@ public:
 		return erase(begin() + ind);
 	}
 
-	void push_back(const T &value) {
-		if (finish == bound) {
-			T *dest = register_new_space();
-			copy_or_move(start, finish, dest);
-			alloc.deallocate(start, finish - start);
-			finish = dest + (finish - start);
-			start = dest;
+	void push_back(const T &value) { emplace_back(value); }
+	void push_back(T &&value) { emplace_back(std::move(value)); }
+
+	/**
+	 * when the vector is full, the new element is constructed in the new
+	 * buffer before the old ones are moved over, so args may refer to an
+	 * element of this vector, and nothing changes if the construction throws.
+	 */
+	template<class... Args>
+	T &emplace_back(Args &&...args) {
+		if (finish != bound) {
+			new (finish) T(std::forward<Args>(args)...);
+			return *finish++;
 		}
-		new (finish) T{value};
-		++finish;
+		size_t sz = finish - start, cap = bound - start;
+		size_t new_cap = cap ? cap * 2 : 2;
+		T *dest = alloc.allocate(new_cap);
+		SJTU_TRY {
+			new (dest + sz) T(std::forward<Args>(args)...);
+		} SJTU_CATCH_ALL {
+			alloc.deallocate(dest, new_cap);
+			SJTU_RETHROW;
+		}
+		count_reallocation(sz);
+		copy_or_move(start, finish, dest);
+		if (start) alloc.deallocate(start, cap);
+		start = dest;
+		finish = dest + sz + 1;
+		bound = dest + new_cap;
+		return dest[sz];
 	}
 
 	void pop_back() {
-		if (start == finish) throw container_is_empty{};
+		if (start == finish) SJTU_THROW(container_is_empty);
 		--finish;
 		finish->~T();
 	}
 
+#ifdef SJTU_STATS
+	struct stats_type {
+		size_t reallocations = 0;// buffers replaced by a larger one
+		size_t bytes_moved = 0;  // bytes of elements relocated into them
+	};
+	const stats_type &stats() const { return _stats; }
+#else
+	struct stats_type {};
+#endif
+
 private:
 	[[no_unique_address]] Alloc alloc;
 	T *start, *finish, *bound;
+	[[no_unique_address]] stats_type _stats;
 
 private:
-	void cover_from_other(const vector<T> &other) {
+	void cover_from_other(const vector &other) {
 		auto sz = other.size();
 		start = alloc.allocate(sz);
 		bound = finish = start + sz;
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			if (sz) std::memcpy(static_cast<void *>(start), other.start, sz * sizeof(T));
+			return;
+		}
 		for (int i = 0; i < sz; ++i)
 			new (start + i) T{other.start[i]};
 	}
@@ -237,10 +296,27 @@ private:
 		sz *= 2;
 		T *ret = alloc.allocate(sz);
 		bound = ret + sz;
+		count_reallocation(finish - start);
 		return ret;
 	}
 
+	// a new buffer taking over n elements; the first buffer does not count.
+	void count_reallocation([[maybe_unused]] size_t n) {
+#ifdef SJTU_STATS
+		if (!start) return;
+		++_stats.reallocations;
+		_stats.bytes_moved += n * sizeof(T);
+		counters::vector_reallocations.add(1);
+		counters::vector_bytes_moved.add(n * sizeof(T));
+#endif
+	}
+
+	// relocate [src, ed) to dest; trivially copyable types are copied as bytes.
 	static void copy_or_move(T *src, T *ed, T *dest) {
+		if constexpr (std::is_trivially_copyable_v<T>) {
+			if (src != ed) std::memcpy(static_cast<void *>(dest), src, (ed - src) * sizeof(T));
+			return;
+		}
 		while (src != ed) {
 			new (dest) T{std::move_if_noexcept(*src)};
 			src->~T();